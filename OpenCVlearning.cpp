@@ -5,6 +5,7 @@
 #include <iostream>
 #include "opencv2/highgui.hpp"
 #include "opencv2/imgproc.hpp"
+#include "main/ImageSource.hpp"
 
 using namespace cv;
 using namespace std;
@@ -30,9 +31,12 @@ int main()
     //cv::createTrackbar("Min Val", MASK_WINDOW, &minVal, 255);
     //cv::createTrackbar("Max Val", MASK_WINDOW, &maxVal, 255);
 
+    // Decoded once and reused while the file on disk is unchanged
+    ImageSource images;
+
     while (true) {
         //// 2. Read and convert image to HSV color space
-        cv::Mat inputImage{ cv::imread("C:/Users/PARHA/source/repos/OpenCVlearning/OpenCVlearning/IMG/redshoe.jpg", cv::IMREAD_COLOR) };
+        cv::Mat inputImage = images.read("C:/Users/PARHA/source/repos/OpenCVlearning/OpenCVlearning/IMG/redshoe.jpg");
         //Mat inputImage = imread("C:/Users/PARHA/source/repos/OpenCVlearning/OpenCVlearning/IMG/red.png");
 
         cv::Mat inputImageHSV;
@@ -1,10 +1,13 @@
 #include <opencv2/opencv.hpp>
 #include <iostream>
 #include <chrono>
+#include "../main/MaxFilter.hpp"
+#include "../main/OverlayRenderer.hpp"
+#include "../main/SelectionSet.hpp"
 using namespace cv;
 
-// Global vector to store contours
-std::vector<std::vector<cv::Point>> contoursList;
+// Contours selected by clicking with findObject
+SelectionSet selection;
 
 cv::Scalar contourColor = cv::Scalar(222, 181, 255);
 
@@ -25,20 +28,10 @@ cv::Point getCenter() {
 }
 
 void drawWeightedContour(cv::Mat image, std::vector<cv::Point> contour) {
-    cv::Mat mask = cv::Mat::zeros(image.size(), CV_8UC1);
-    std::vector<std::vector<cv::Point>> contours = { contour };
-    cv::drawContours(mask, contours, -1, cv::Scalar(255), cv::FILLED);
-
-    // Create an opaque version of the original image
-    cv::Mat overlayedImage = image.clone();
-
-    // Apply the mask to the overlayed image
-    overlayedImage.setTo(contourColor, mask);
-
-    // Blend the overlayed image with the original image
-    double alpha = 0.4;
-    cv::addWeighted(overlayedImage, alpha, image, 1.0 - alpha, 0, image);
-    cv::drawContours(image, contours, -1, contourColor, 1 + ((image.rows + image.cols) / 400));
+    // Blends only inside the contour's bounding box instead of over the whole image
+    OverlayRenderer overlay;
+    overlay.color = contourColor;
+    overlay.draw(image, std::vector<std::vector<cv::Point>>{ contour }, 0);
 }
 
 cv::Mat readImage(const std::string& imgPath) {
@@ -65,7 +58,7 @@ cv::Mat getEdges(cv::Mat image) {
     cv::Canny(blurredImage, edges, 30, 60);
 
     cv::Mat dilatedEdges;
-    cv::dilate(edges, dilatedEdges, cv::Mat(), cv::Point(-1, -1), 1 + ((image.rows + image.cols) / 1500));
+    dilateSquare(edges, dilatedEdges, 1 + ((image.rows + image.cols) / 1500));
 
     return dilatedEdges;
 }
@@ -84,7 +77,7 @@ std::vector<std::vector<cv::Point>> getContours(cv::Mat& image) {
 
     // Apply dilation to enhance edges
     cv::Mat dilatedEdges;
-    cv::dilate(edges, dilatedEdges, cv::Mat(), cv::Point(-1, -1), 2 + ((image.rows + image.cols) / 1500));
+    dilateSquare(edges, dilatedEdges, 2 + ((image.rows + image.cols) / 1500));
 
     // Find contours in the mask
     std::vector<std::vector<cv::Point>> contours;
@@ -103,64 +96,69 @@ std::vector<std::vector<cv::Point>> getContours(cv::Mat& image) {
     return filteredContours;
 }
 
+// Selects the object at (x, y) and returns a copy of image with every selected outline drawn on it.
+// image should be the clean frame each time: outlines drawn on it would be found as edges, and
+// outlines of selections that were replaced or undone could not be taken off again.
 cv::Mat findObject(cv::Mat image, int x, int y) {
+    int thickness = 2 + ((image.rows + image.cols) / 200);
 
     // Create a point for the specific pixel
     cv::Point point(x, y);
 
-    std::vector<std::vector<cv::Point>> contours = getContours(image);
+    //check if the sent point is already in a selected contour
+    int selectedId = selection.findAt(point);
+    if (selectedId > -1) {
+        cv::Mat result = image.clone();
+        selection.draw(result, contourColor, thickness);
 
-    //check if the sent point is already in a contour
-    for (const auto& contour : contoursList) {
-        if (cv::pointPolygonTest(contour, point, false) >= 0) {
+        std::vector<std::vector<cv::Point>> selected = { selection.getContour(selectedId) };
+        cv::drawContours(result, selected, -1, cv::Scalar(0, 255, 0), thickness);
 
-            cv::drawContours(image, std::vector<std::vector<cv::Point>>{contour}, -1, cv::Scalar(0, 255, 0), 2 + ((image.rows + image.cols) / 200));
-
-            return image;
-        }
+        return result;
     }
 
-    // One problem is that smaller contours could still be added to larger ones, which could cause problems
+    std::vector<std::vector<cv::Point>> contours = getContours(image);
+
     // Check if the specific pixel is within any contour
     for (const auto& contour : contours) {
         if (cv::pointPolygonTest(contour, point, false) >= 0) {
 
-            //Add contour to the list
-            contoursList.push_back(contour);
-            cv::circle(image, point, 5, cv::Scalar(255, 0, 0), -1); // Draw the specific pixel
+            // A contour nested in an already selected one gives the id of the enclosing selection,
+            // and selections the new contour encloses are replaced by it
+            selectedId = selection.add(contour);
             break;
         }
     }
 
-    // Draw the contours containing the specific pixels
-    cv::drawContours(image, contoursList, -1, contourColor, 2 + ((image.rows + image.cols) / 200));
+    cv::Mat result = image.clone();
+    selection.draw(result, contourColor, thickness);
+    if (selectedId > -1) {
+        cv::circle(result, point, 5, cv::Scalar(255, 0, 0), -1); // Draw the specific pixel
+    }
 
-    return image;
+    return result;
 }
 
 void clearContourList() {
-    contoursList.clear();
+    selection.clear();
 }
 
-// Function to remove the newest contour from the list (if not empty)
-void removeNewestContour(cv::Mat image) {
-    if (!contoursList.empty()) {
-        contoursList.pop_back(); // Remove the most recently added contour
-    }
+// Function to undo the newest selection (if any), returning a copy of the clean frame with what is left drawn on it
+cv::Mat removeNewestContour(cv::Mat image) {
+    selection.undo();
 
-    cv::drawContours(image, contoursList, -1, contourColor, 2 + ((image.rows + image.cols) / 200));
+    cv::Mat result = image.clone();
+    selection.draw(result, contourColor, 2 + ((image.rows + image.cols) / 200));
+
+    return result;
 }
 
 int findArea() {
-    double area = 0;
+    // Total area is kept up to date as contours are selected
+    double area = selection.getTotalArea();
 
-    //Calculate total area of all contours
-    for (const auto& contour : contoursList) {
-        area += cv::contourArea(contour);
-    }
-
-    //Clear the global contour list
-    contoursList.clear();
+    //Clear the selection
+    selection.clear();
 
     return area;
 }
@@ -259,12 +257,12 @@ int main() {
         centerObjectInfo(image);
         cv::imshow("Image", image);
     } else if (true){
-        image = findObject(image, 170, 130);
-        image = findObject(image, 230, 140);
-        cv::imshow("Image", image);
+        cv::Mat selected = findObject(image, 170, 130);
+        selected = findObject(image, 230, 140);
+        cv::imshow("Image", selected);
         int area = findArea();
         std::cout << "Area of object: " << area << std::endl;
-        cv::imwrite("C:/Users/Sebastian WL/Desktop/Results/img.jpg", image);
+        cv::imwrite("C:/Users/Sebastian WL/Desktop/Results/img.jpg", selected);
 
     } else if (true) {
         //centerObjectInfo(image);
@@ -282,7 +280,7 @@ int main() {
     auto end = std::chrono::high_resolution_clock::now();
     auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
 
-    std::cout << "Execution time: " << duration.count() << " microseconds" << std::endl;
+    std::cout << "Execution time: " << duration.count() << " milliseconds" << std::endl;
 
     waitKey(0);
 
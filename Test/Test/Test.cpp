@@ -1,5 +1,7 @@
 #include <opencv2/opencv.hpp>
 #include <iostream>
+#include "../../main/ColorStatistics.hpp"
+#include "../../main/HSVRangeMask.hpp"
 using namespace cv;
 
 //All write contour functions are experimental
@@ -126,49 +128,19 @@ cv::Mat readImage(const std::string& imgPath) {
 }
 
 int getAverageHSV(const cv::Mat& image) {
-    // Get image dimensions
-    int rows = image.rows;
-    int cols = image.cols;
-
-    //Should maybe make it dependant on the size of the image
-    // Calculate the region of interest (ROI) in the middle of the image
-    int startX = cols / 2 - 4;
-    int endX = cols / 2 + 4;
-    int startY = rows / 2 - 4;
-    int endY = rows / 2 + 4;
-
-    // Initialize accumulators for HSV values
-    double totalH = 0, totalS = 0, totalV = 0;
-    int numPixels = 0;
-
-    // Iterate over the ROI to accumulate HSV values
-    for (int y = startY; y < endY; y++) {
-        for (int x = startX; x < endX; x++) {
-            cv::Vec3b bgrPixel = image.at<cv::Vec3b>(y, x);
-            cv::Mat bgrMat(1, 1, CV_8UC3);
-            bgrMat.at<cv::Vec3b>(0, 0) = bgrPixel;
-
-            cv::Mat hsvMat;
-            cv::cvtColor(bgrMat, hsvMat, cv::COLOR_BGR2HSV);
-
-            cv::Vec3b hsvPixel = hsvMat.at<cv::Vec3b>(0, 0);
-
-            totalH += hsvPixel[0];
-            totalS += hsvPixel[1];
-            totalV += hsvPixel[2];
-            numPixels++;
-        }
+    if (image.empty()) {
+        std::cerr << "Error: Could not open the image file." << std::endl;
+        return -1;
     }
 
-    // Calculate average HSV values
-    int avgH = static_cast<int>(totalH / numPixels);
-    int avgS = static_cast<int>(totalS / numPixels);
-    int avgV = static_cast<int>(totalV / numPixels);
+    // Average over a region in the middle of the image that grows with the image size
+    ColorStatistics colorStatistics;
+    HSVStatistics stats = colorStatistics.compute(image, ColorStatistics::getCenterRegion(image.size()));
 
     // Combine average HSV values into a single integer
-    int hsvValue = (avgH << 16) | (avgS << 8) | avgV;
+    int hsvValue = (stats.mean[0] << 16) | (stats.mean[1] << 8) | stats.mean[2];
 
-    std::cout << "Number of pixels used: " << numPixels << std::endl;
+    std::cout << "Number of pixels used: " << stats.pixelCount << std::endl;
 
     return hsvValue;
 }
@@ -180,49 +152,15 @@ int getHSV(const cv::Mat srcImage) {
         return -1;
     }
 
-    // Get image dimensions
-    int rows = srcImage.rows;
-    int cols = srcImage.cols;
+    // Convert only the pixel in the middle of the image
+    ColorStatistics colorStatistics;
+    HSVStatistics stats = colorStatistics.compute(srcImage, cv::Rect(srcImage.cols / 2, srcImage.rows / 2, 1, 1));
 
-    // Calculate the coordinates of the pixel in the middle of the image
-    int centerX = cols / 2;
-    int centerY = rows / 2;
-
-    // Convert BGR to HSV
-    cv::Mat3b bgrImage(srcImage);
-    cv::Mat3b hsvImage;
-    cv::cvtColor(bgrImage, hsvImage, cv::COLOR_BGR2HSV);
-
-    // Get the HSV values of the pixel in the middle of the image
-    cv::Vec3b hsvColor = hsvImage(centerY, centerX);
-
-    int hsvValue = (hsvColor[0] << 16) | (hsvColor[1] << 8) | hsvColor[2];
+    int hsvValue = (stats.mean[0] << 16) | (stats.mean[1] << 8) | stats.mean[2];
 
     return hsvValue;
 }
 
-cv::Mat createMask(const cv::Mat& inputImage, const cv::Scalar& lowerBound, const cv::Scalar& upperBound) {
-    // Convert image to HSV color space
-    cv::Mat inputImageHSV;
-    cv::cvtColor(inputImage, inputImageHSV, cv::COLOR_BGR2HSV);
-
-    // Create mask
-    cv::Mat mask;
-    cv::inRange(inputImageHSV, lowerBound, upperBound, mask);
-
-    return mask;
-}
-
-cv::Mat applyMask(const cv::Mat& image, const cv::Mat& mask) {
-    cv::Mat resultImage;
-    cv::bitwise_and(image, image, resultImage, mask);
-
-    cv::imshow("Input Image", image);
-    cv::imshow("Result (Masked) Image", resultImage);
-
-    return resultImage;
-}
-
 int main() {
     std::string imgPath = "C:/Users/Sebastian WL/Desktop/Images/stop.jpg";
     int range = 3;
@@ -264,54 +202,9 @@ int main() {
         int minSat = 100, maxSat = 255;
         int minVal = 0, maxVal = 255;
 
-        cv::Scalar lowerBound;
-        cv::Scalar upperBound;
-
-        if (h < range || h > (180 - range)) {
-
-            cv::Scalar lowerBound2;
-            cv::Scalar upperBound2;
-
-            cv::Mat mask1, mask2;
-
-            if (h < 5) {
-                int minHue1 = 0, maxHue1 = h + range;
-                int minHue2 = 179 - (range - h), maxHue2 = 180;
-
-                lowerBound = cv::Scalar(minHue1, minSat, minVal);
-                upperBound = cv::Scalar(maxHue1, maxSat, maxVal);
-
-                lowerBound2 = cv::Scalar(minHue2, minSat, minVal);
-                upperBound2 = cv::Scalar(maxHue2, maxSat, maxVal);
-            }
-            else {
-                int minHue1 = h - range, maxHue1 = 180;
-                int minHue2 = 0, maxHue2 = range - (180 - h);
-
-                lowerBound = cv::Scalar(minHue1, minSat, minVal);
-                upperBound = cv::Scalar(maxHue1, maxSat, maxVal);
-
-                lowerBound2 = cv::Scalar(minHue2, minSat, minVal);
-                upperBound2 = cv::Scalar(maxHue2, maxSat, maxVal);
-            }
-
-            mask1 = createMask(image, lowerBound, upperBound);
-            mask2 = createMask(image, lowerBound2, upperBound2);
-
-            mask = mask1 | mask2;
-
-            resultImage = applyMask(image, mask);
-        }
-        else {
-            int minHue = h - range, maxHue = h + range;
-
-            lowerBound = cv::Scalar(minHue, minSat, minVal);
-            upperBound = cv::Scalar(maxHue, maxSat, maxVal);
-
-            mask = createMask(image, lowerBound, upperBound);
-
-            resultImage = applyMask(image, mask);
-        }
+        // The hue range wraps around red by itself, so mask and masked image come from one pass
+        HSVRangeMask hsvMask({ HueRange::around(h, range) }, minSat, maxSat, minVal, maxVal);
+        hsvMask.apply(image, mask, resultImage);
 
         cv::imwrite("C:/Users/Sebastian WL/Desktop/Results/img.png", resultImage);
     }
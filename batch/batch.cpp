@@ -0,0 +1,320 @@
+#include <opencv2/opencv.hpp>
+#include <iostream>
+#include <fstream>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <atomic>
+#include <algorithm>
+#include <cstdlib>
+#include <cctype>
+#include "../main/ImageSource.hpp"
+#include "../main/ObjectDetection.hpp"
+#include "../main/ResultWriter.hpp"
+using namespace cv;
+
+// Headless batch runner: finds the center object of every image in a directory,
+// glob pattern or file list and writes one CSV line per image, or image and center object
+// records as JSON lines or length-prefixed binary (see ResultWriter).
+//
+// Usage: batch <directory | "pattern*.jpg" | @filelist.txt> [output] [threads] [csv | jsonl | binary] [--gray]
+//
+// --gray decodes straight to grayscale, which skips the color conversion. The decoder's luma can differ
+// from cvtColor by one gray level on a few pixels, so results can differ slightly from a color decode.
+
+struct BatchResult {
+    uint32_t imageId;
+    std::string path;
+    bool ok;
+    int objectCount;
+    double area;
+    cv::Point center;
+    ObjectRecord record;
+};
+
+// Per-worker queue of image indices; the owner takes from the front and idle workers steal from the back
+class WorkQueue {
+public:
+    void push(size_t item) {
+        std::lock_guard<std::mutex> lock(mutex);
+        items.push_back(item);
+    }
+
+    bool pop(size_t& item) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (items.empty()) {
+            return false;
+        }
+        item = items.front();
+        items.pop_front();
+        return true;
+    }
+
+    bool steal(size_t& item) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (items.empty()) {
+            return false;
+        }
+        item = items.back();
+        items.pop_back();
+        return true;
+    }
+
+private:
+    std::mutex mutex;
+    std::deque<size_t> items;
+};
+
+// Hands finished results to the writer thread so workers never wait on the output file
+class ResultQueue {
+public:
+    void push(BatchResult result) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            results.push_back(std::move(result));
+        }
+        ready.notify_one();
+    }
+
+    // Blocks until a result is available, returns false once closed and drained
+    bool pop(BatchResult& result) {
+        std::unique_lock<std::mutex> lock(mutex);
+        ready.wait(lock, [this] { return !results.empty() || closed; });
+        if (results.empty()) {
+            return false;
+        }
+        result = std::move(results.front());
+        results.pop_front();
+        return true;
+    }
+
+    void close() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            closed = true;
+        }
+        ready.notify_all();
+    }
+
+private:
+    std::mutex mutex;
+    std::condition_variable ready;
+    std::deque<BatchResult> results;
+    bool closed = false;
+};
+
+bool isImageFile(const std::string& path) {
+    static const char* extensions[] = { ".jpg", ".jpeg", ".png", ".bmp", ".tif", ".tiff" };
+
+    std::string lower = path;
+    std::transform(lower.begin(), lower.end(), lower.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+
+    for (const char* extension : extensions) {
+        std::string ext(extension);
+        if (lower.size() >= ext.size() && lower.compare(lower.size() - ext.size(), ext.size(), ext) == 0) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+std::vector<std::string> listImages(const std::string& input) {
+    std::vector<std::string> paths;
+
+    // @file.txt holds one image path per line
+    if (!input.empty() && input[0] == '@') {
+        std::ifstream list(input.substr(1));
+        std::string line;
+        while (std::getline(list, line)) {
+            if (!line.empty() && line.back() == '\r') {
+                line.pop_back();
+            }
+            if (!line.empty()) {
+                paths.push_back(line);
+            }
+        }
+        return paths;
+    }
+
+    // cv::glob lists every file for a directory and expands wildcards otherwise
+    std::vector<cv::String> files;
+    cv::glob(input, files, false);
+
+    for (const auto& file : files) {
+        if (isImageFile(file)) {
+            paths.push_back(file);
+        }
+    }
+
+    return paths;
+}
+
+BatchResult processImage(ObjectDetection& detection, ImageSource& images, uint32_t imageId, const std::string& path, bool gray) {
+    BatchResult result;
+    result.imageId = imageId;
+    result.path = path;
+    result.ok = false;
+    result.objectCount = 0;
+    result.area = 0;
+    result.center = cv::Point(0, 0);
+    result.record = FrameAnalysis().getRecord(-1, imageId);
+
+    DecodeRequest request;
+    request.color = !gray;
+
+    cv::Mat image = images.read(path, request);
+    if (image.empty()) {
+        return result;
+    }
+
+    FrameAnalysis analysis = detection.analyze(image);
+
+    // Same selection as centerObjectInfo, without drawing into the image
+    int centerContourIndex = analysis.findCenterObject();
+    if (centerContourIndex > -1) {
+        cv::Moments mu = analysis.getMoments(centerContourIndex);
+        result.center.x = static_cast<int>(mu.m10 / mu.m00);
+        result.center.y = static_cast<int>(mu.m01 / mu.m00);
+        result.area = analysis.getArea(centerContourIndex);
+        result.record = analysis.getRecord(centerContourIndex, imageId);
+    }
+
+    result.ok = true;
+    result.objectCount = analysis.getObjectCount();
+
+    return result;
+}
+
+int main(int argc, char** argv) {
+    // --gray may appear anywhere, the other arguments are positional
+    bool gray = false;
+    std::vector<char*> arguments;
+    for (int i = 0; i < argc; i++) {
+        if (std::string(argv[i]) == "--gray") {
+            gray = true;
+        }
+        else {
+            arguments.push_back(argv[i]);
+        }
+    }
+    argc = static_cast<int>(arguments.size());
+    argv = arguments.data();
+
+    if (argc < 2) {
+        std::cerr << "Usage: batch <directory | pattern | @filelist.txt> [output] [threads] [csv | jsonl | binary] [--gray]" << std::endl;
+        return 1;
+    }
+
+    std::string format = argc > 4 ? argv[4] : "csv";
+    if (format != "csv" && format != "jsonl" && format != "binary") {
+        std::cerr << "Error: Unknown output format " << format << std::endl;
+        return 1;
+    }
+
+    std::vector<std::string> paths = listImages(argv[1]);
+    if (paths.empty()) {
+        std::cerr << "Error: No images found for " << argv[1] << std::endl;
+        return 1;
+    }
+
+    std::ofstream outputFile;
+    if (argc > 2) {
+        outputFile.open(argv[2], format == "binary" ? std::ios::out | std::ios::binary : std::ios::out);
+        if (!outputFile.is_open()) {
+            std::cerr << "Error: Could not open the output file." << std::endl;
+            return 1;
+        }
+    }
+    std::ostream& output = outputFile.is_open() ? outputFile : std::cout;
+
+    int threadCount = argc > 3 ? std::atoi(argv[3]) : static_cast<int>(std::thread::hardware_concurrency());
+    threadCount = std::max(1, std::min(threadCount, static_cast<int>(paths.size())));
+
+    // Each worker already owns a core, so OpenCV must not start its own thread pool on top
+    cv::setNumThreads(1);
+
+    std::vector<WorkQueue> queues(threadCount);
+    for (size_t i = 0; i < paths.size(); i++) {
+        queues[i % threadCount].push(i);
+    }
+
+    ResultQueue results;
+    std::atomic<size_t> failed(0);
+
+    // Every image is read once, so nothing is cached
+    ImageSource images(0);
+
+    auto start = std::chrono::high_resolution_clock::now();
+
+    // The writer runs on its own thread so result I/O overlaps decoding and detection
+    std::thread writer([&]() {
+        BatchResult result;
+
+        if (format != "csv") {
+            ResultWriter records(output, format == "binary" ? ResultFormat::Binary : ResultFormat::JsonLines);
+            while (results.pop(result)) {
+                if (!result.ok) {
+                    failed++;
+                }
+                records.writeImage(result.imageId, result.path, result.ok, result.objectCount);
+                if (result.record.objectId > -1) {
+                    records.writeObject(result.record);
+                }
+            }
+            records.flush();
+            return;
+        }
+
+        output << "path,objects,area,center_x,center_y" << "\n";
+
+        while (results.pop(result)) {
+            if (!result.ok) {
+                failed++;
+                output << result.path << ",error,,," << "\n";
+                continue;
+            }
+            output << result.path << "," << result.objectCount << "," << result.area << ","
+                << result.center.x << "," << result.center.y << "\n";
+        }
+        output.flush();
+    });
+
+    std::vector<std::thread> workers;
+    for (int worker = 0; worker < threadCount; worker++) {
+        workers.emplace_back([&, worker]() {
+            ObjectDetection detection;
+            size_t item;
+
+            while (true) {
+                bool found = queues[worker].pop(item);
+
+                // Steal from the other workers once the own queue runs dry
+                for (int offset = 1; !found && offset < threadCount; offset++) {
+                    found = queues[(worker + offset) % threadCount].steal(item);
+                }
+                if (!found) {
+                    break;
+                }
+
+                results.push(processImage(detection, images, static_cast<uint32_t>(item), paths[item], gray));
+            }
+        });
+    }
+
+    for (auto& thread : workers) {
+        thread.join();
+    }
+    results.close();
+    writer.join();
+
+    auto end = std::chrono::high_resolution_clock::now();
+    double seconds = std::chrono::duration<double>(end - start).count();
+
+    std::cerr << "Processed " << paths.size() << " images (" << failed << " failed) with " << threadCount
+        << " threads in " << seconds << " s, " << paths.size() / seconds << " images/sec" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,59 @@
+#ifndef SYNTHETICIMAGE_HPP
+#define SYNTHETICIMAGE_HPP
+
+#include <opencv2/opencv.hpp>
+using namespace cv;
+
+// Light background with a grid of darker discs, similar to a blood smear.
+// spacing is the distance between disc centers, smaller values give more objects.
+inline cv::Mat createSyntheticImage(int width, int height, int spacing) {
+    cv::Mat image(height, width, CV_8UC3, cv::Scalar(230, 225, 235));
+    cv::RNG rng(12345);
+
+    for (int y = spacing / 2; y < height; y += spacing) {
+        for (int x = spacing / 2; x < width; x += spacing) {
+            int radius = spacing / 3 + rng.uniform(-spacing / 10, spacing / 10 + 1);
+            cv::circle(image, cv::Point(x, y), radius, cv::Scalar(120, 60, 170), cv::FILLED);
+        }
+    }
+
+    return image;
+}
+
+// Crowded discs of varying size at jittered grid positions, many of them touching their neighbours,
+// similar to a dense smear. spacing is the distance between grid positions.
+inline cv::Mat createDenseImage(int width, int height, int spacing) {
+    cv::Mat image(height, width, CV_8UC3, cv::Scalar(230, 225, 235));
+    cv::RNG rng(54321);
+
+    for (int y = spacing / 2; y < height; y += spacing) {
+        for (int x = spacing / 2; x < width; x += spacing) {
+            cv::Point center(x + rng.uniform(-spacing / 12, spacing / 12 + 1), y + rng.uniform(-spacing / 12, spacing / 12 + 1));
+            int radius = spacing * 5 / 12 + rng.uniform(-spacing / 12, spacing / 12 + 1);
+            cv::circle(image, center, radius, cv::Scalar(120, 60, 170), cv::FILLED);
+        }
+    }
+
+    return image;
+}
+
+// Large cells with a darker nucleus, in pairs that touch. The nucleus outline lies inside its
+// cell's, so only the cell is an external contour, and each touching pair forms one outline.
+// spacing is the distance between cell centers within a row of pairs.
+inline cv::Mat createNestedImage(int width, int height, int spacing) {
+    cv::Mat image(height, width, CV_8UC3, cv::Scalar(230, 225, 235));
+    int radius = spacing * 2 / 5;
+
+    for (int y = spacing / 2; y < height; y += spacing) {
+        for (int x = spacing / 2, column = 0; x < width; x += spacing, column++) {
+            // Every second cell moves left until it touches its neighbour
+            cv::Point center(column % 2 == 1 ? x - (spacing - 2 * radius) : x, y);
+            cv::circle(image, center, radius, cv::Scalar(150, 110, 190), cv::FILLED);
+            cv::circle(image, center, radius / 2, cv::Scalar(90, 30, 120), cv::FILLED);
+        }
+    }
+
+    return image;
+}
+
+#endif // SYNTHETICIMAGE_HPP
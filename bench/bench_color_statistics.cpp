@@ -0,0 +1,91 @@
+// Compares the original colour sampling in Test/Test/Test.cpp (one 1x1 cvtColor per pixel of an
+// 8x8 window, or a full-frame cvtColor to read one pixel) with ColorStatistics on the scaled
+// center region, and checks saturation and value means against converting the region at once.
+//
+// Build: cmake -S .. -B build && cmake --build build --target bench_color_statistics
+// Output: one CSV line per image size (megapixels,region_pixels,per_pixel_us,full_frame_us,statistics_us)
+
+#include <opencv2/opencv.hpp>
+#include <iostream>
+#include <chrono>
+#include <cstdlib>
+#include "../main/ColorStatistics.hpp"
+#include "SyntheticImage.hpp"
+using namespace cv;
+
+cv::Vec3b perPixelAverage(const cv::Mat& image) {
+    double totals[3] = { 0, 0, 0 };
+
+    for (int y = image.rows / 2 - 4; y < image.rows / 2 + 4; y++) {
+        for (int x = image.cols / 2 - 4; x < image.cols / 2 + 4; x++) {
+            cv::Mat bgrMat(1, 1, CV_8UC3);
+            bgrMat.at<cv::Vec3b>(0, 0) = image.at<cv::Vec3b>(y, x);
+
+            cv::Mat hsvMat;
+            cv::cvtColor(bgrMat, hsvMat, cv::COLOR_BGR2HSV);
+
+            for (int c = 0; c < 3; c++) {
+                totals[c] += hsvMat.at<cv::Vec3b>(0, 0)[c];
+            }
+        }
+    }
+
+    return cv::Vec3b(cv::saturate_cast<uchar>(totals[0] / 64), cv::saturate_cast<uchar>(totals[1] / 64), cv::saturate_cast<uchar>(totals[2] / 64));
+}
+
+cv::Vec3b fullFramePixel(const cv::Mat& image) {
+    cv::Mat hsvImage;
+    cv::cvtColor(image, hsvImage, cv::COLOR_BGR2HSV);
+
+    return hsvImage.at<cv::Vec3b>(image.rows / 2, image.cols / 2);
+}
+
+int main(int argc, char** argv) {
+    int repetitions = argc > 1 ? std::atoi(argv[1]) : 100;
+
+    const cv::Size sizes[] = { cv::Size(640, 480), cv::Size(1920, 1080), cv::Size(4000, 3000), cv::Size(8000, 6000) };
+
+    std::cout << "megapixels,region_pixels,per_pixel_us,full_frame_us,statistics_us" << std::endl;
+
+    for (const cv::Size& size : sizes) {
+        cv::Mat image = createSyntheticImage(size.width, size.height, 120);
+        cv::Rect region = ColorStatistics::getCenterRegion(size);
+
+        ColorStatistics colorStatistics;
+        HSVStatistics stats;
+        cv::Vec3b sample;
+
+        auto start = std::chrono::high_resolution_clock::now();
+        for (int i = 0; i < repetitions; i++) {
+            sample = perPixelAverage(image);
+        }
+        auto perPixelEnd = std::chrono::high_resolution_clock::now();
+        for (int i = 0; i < repetitions; i++) {
+            sample = fullFramePixel(image);
+        }
+        auto fullFrameEnd = std::chrono::high_resolution_clock::now();
+        for (int i = 0; i < repetitions; i++) {
+            stats = colorStatistics.compute(image, region);
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+
+        // Saturation and value means must match converting the whole region in one call
+        cv::Mat hsvRegion;
+        cv::cvtColor(image(region), hsvRegion, cv::COLOR_BGR2HSV);
+        cv::Scalar reference = cv::mean(hsvRegion);
+        for (int c = 1; c < 3; c++) {
+            if (std::abs(stats.mean[c] - reference[c]) > 0.5) {
+                std::cerr << "Error: channel " << c << " mean " << static_cast<int>(stats.mean[c]) << " differs from " << reference[c] << std::endl;
+                return 1;
+            }
+        }
+
+        double perPixelUs = std::chrono::duration<double, std::micro>(perPixelEnd - start).count() / repetitions;
+        double fullFrameUs = std::chrono::duration<double, std::micro>(fullFrameEnd - perPixelEnd).count() / repetitions;
+        double statisticsUs = std::chrono::duration<double, std::micro>(end - fullFrameEnd).count() / repetitions;
+
+        std::cout << size.area() / 1e6 << "," << stats.pixelCount << "," << perPixelUs << "," << fullFrameUs << "," << statisticsUs << std::endl;
+    }
+
+    return 0;
+}
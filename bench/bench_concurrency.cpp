@@ -0,0 +1,101 @@
+// Stress test of the reentrant ObjectDetection queries: one shared const instance answers
+// center and point queries on one shared image from 1, 2, 4, ... threads, without cloning.
+// Every thread's results must match a single-threaded run, and the image must be unchanged.
+//
+// Usage: bench_concurrency [queries_per_thread] [max_threads]
+//   queries_per_thread  queries each thread runs (default 200)
+//   max_threads         largest thread count (default: hardware concurrency)
+//
+// Build: cmake -S .. -B build && cmake --build build --target bench_concurrency
+// Output: one CSV line per thread count (threads,queries,ms,queries_per_second,scaling)
+
+#include <opencv2/opencv.hpp>
+#include <iostream>
+#include <chrono>
+#include <thread>
+#include <atomic>
+#include <cstdlib>
+#include "../main/ObjectDetection.hpp"
+#include "SyntheticImage.hpp"
+using namespace cv;
+
+bool sameRecord(const ObjectRecord& a, const ObjectRecord& b) {
+    return a.objectId == b.objectId && a.area == b.area && a.centroidX == b.centroidX && a.centroidY == b.centroidY
+        && a.boxX == b.boxX && a.boxY == b.boxY && a.boxWidth == b.boxWidth && a.boxHeight == b.boxHeight;
+}
+
+int main(int argc, char** argv) {
+    int queries = argc > 1 ? std::atoi(argv[1]) : 200;
+    int maxThreads = argc > 2 ? std::atoi(argv[2]) : static_cast<int>(std::thread::hardware_concurrency());
+
+    if (queries < 1 || maxThreads < 1) {
+        std::cerr << "Usage: bench_concurrency [queries_per_thread >= 1] [max_threads >= 1]" << std::endl;
+        return 1;
+    }
+
+    // Threads are the unit of parallelism here, so OpenCV must not add its own pool on top
+    cv::setNumThreads(1);
+
+    const cv::Mat image = createSyntheticImage(1920, 1080, 120);
+    const double checksum = cv::sum(image)[0];
+    const ObjectDetection detection;
+
+    // Query points on a grid of disc centers, and the expected answers from one thread
+    std::vector<cv::Point> points;
+    for (int i = 0; i < 64; i++) {
+        points.push_back(cv::Point(60 + (i % 16) * 120, 60 + (i / 16) * 120));
+    }
+    ObjectRecord expectedCenter = detection.queryCenterObject(image);
+    std::vector<ObjectRecord> expectedPoints;
+    for (const cv::Point& point : points) {
+        expectedPoints.push_back(detection.queryObjectAt(image, point));
+    }
+
+    std::cout << "threads,queries,ms,queries_per_second,scaling" << std::endl;
+
+    double singleRate = 0;
+    for (int threadCount = 1; threadCount <= maxThreads; threadCount *= 2) {
+        std::atomic<int> mismatches(0);
+        std::vector<std::thread> threads;
+
+        auto start = std::chrono::high_resolution_clock::now();
+        for (int t = 0; t < threadCount; t++) {
+            threads.emplace_back([&, t]() {
+                // Each thread renders into its own output, the shared image is only read
+                cv::Mat output;
+                for (int i = 0; i < queries; i++) {
+                    if (i % 8 == 0) {
+                        if (!sameRecord(detection.queryCenterObject(image, &output), expectedCenter)) {
+                            mismatches++;
+                        }
+                        continue;
+                    }
+
+                    size_t p = (t * queries + i) % points.size();
+                    if (!sameRecord(detection.queryObjectAt(image, points[p]), expectedPoints[p])) {
+                        mismatches++;
+                    }
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+
+        if (mismatches > 0 || cv::sum(image)[0] != checksum) {
+            std::cerr << "Error: " << mismatches << " wrong results with " << threadCount << " threads" << std::endl;
+            return 1;
+        }
+
+        double ms = std::chrono::duration<double, std::milli>(end - start).count();
+        double rate = threadCount * queries / (ms / 1000);
+        if (threadCount == 1) {
+            singleRate = rate;
+        }
+
+        std::cout << threadCount << "," << threadCount * queries << "," << ms << "," << rate << "," << rate / (singleRate * threadCount) << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,80 @@
+// Compares filling the statistics of every raw contour the way FrameAnalysis used to (cv::contourArea,
+// cv::moments and cv::boundingRect per contour, serially) with the one-pass parallel ContourStats.
+// Dense synthetic images give thousands of contours. Areas, moments and boxes must match exactly.
+//
+// Usage: bench_contour_stats [spacing] [repetitions]
+//   spacing      distance between synthetic objects in pixels, smaller is denser (default 30)
+//   repetitions  timed runs per method (default 20)
+//
+// Build: cmake -S .. -B build && cmake --build build --target bench_contour_stats
+// Output: one CSV line per image size (width,height,contours,serial_ms,table_ms,speedup)
+
+#include <opencv2/opencv.hpp>
+#include <iostream>
+#include <chrono>
+#include <cstdlib>
+#include "../main/ContourStats.hpp"
+#include "../main/EdgePreprocessor.hpp"
+#include "SyntheticImage.hpp"
+using namespace cv;
+
+int main(int argc, char** argv) {
+    int spacing = argc > 1 ? std::atoi(argv[1]) : 30;
+    int repetitions = argc > 2 ? std::atoi(argv[2]) : 20;
+
+    if (spacing < 10 || repetitions < 1) {
+        std::cerr << "Usage: bench_contour_stats [spacing >= 10] [repetitions >= 1]" << std::endl;
+        return 1;
+    }
+
+    const cv::Size sizes[] = { cv::Size(1920, 1080), cv::Size(4000, 3000), cv::Size(8000, 6000) };
+
+    std::cout << "width,height,contours,serial_ms,table_ms,speedup" << std::endl;
+
+    for (const cv::Size& size : sizes) {
+        cv::Mat image = createSyntheticImage(size.width, size.height, spacing);
+
+        EdgePreprocessor preprocessor;
+        cv::Mat dilatedEdges;
+        std::vector<std::vector<cv::Point>> contours;
+        preprocessor.process(image, dilatedEdges, 2 + ((image.rows + image.cols) / 1500));
+        cv::findContours(dilatedEdges, contours, cv::RETR_EXTERNAL, cv::CHAIN_APPROX_SIMPLE);
+
+        std::vector<double> areas(contours.size());
+        std::vector<cv::Moments> moments(contours.size());
+        std::vector<cv::Rect> boxes(contours.size());
+        ScratchArena arena;
+        ContourStats stats;
+
+        double serialMs = 0;
+        double tableMs = 0;
+        for (int i = 0; i < repetitions; i++) {
+            auto start = std::chrono::high_resolution_clock::now();
+            for (size_t j = 0; j < contours.size(); j++) {
+                areas[j] = cv::contourArea(contours[j]);
+                moments[j] = cv::moments(contours[j]);
+                boxes[j] = cv::boundingRect(contours[j]);
+            }
+            auto middle = std::chrono::high_resolution_clock::now();
+            stats.compute(contours, arena);
+            auto end = std::chrono::high_resolution_clock::now();
+
+            serialMs += std::chrono::duration<double, std::milli>(middle - start).count();
+            tableMs += std::chrono::duration<double, std::milli>(end - middle).count();
+        }
+
+        for (size_t j = 0; j < contours.size(); j++) {
+            cv::Rect box(stats.boxX[j], stats.boxY[j], stats.boxWidth[j], stats.boxHeight[j]);
+            if (stats.areas[j] != areas[j] || stats.m00[j] != moments[j].m00 || stats.m10[j] != moments[j].m10
+                || stats.m01[j] != moments[j].m01 || box != boxes[j]) {
+                std::cerr << "Error: statistics of contour " << j << " differ" << std::endl;
+                return 1;
+            }
+        }
+
+        std::cout << size.width << "," << size.height << "," << contours.size() << ","
+            << serialMs / repetitions << "," << tableMs / repetitions << "," << serialMs / tableMs << std::endl;
+    }
+
+    return 0;
+}
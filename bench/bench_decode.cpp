@@ -0,0 +1,93 @@
+// Times reading a JPEG of a synthetic image through ImageSource in every decode mode, and
+// a repeated read served from the cache, next to a plain cv::imread in color.
+// Also reports how many objects a full-frame analyze finds on the grayscale and reduced decodes.
+//
+// Usage: bench_decode [directory] [repetitions]
+//   directory    where the temporary JPEG files are written (default .)
+//   repetitions  timed reads per mode (default 10)
+//
+// Build: cmake -S .. -B build && cmake --build build --target bench_decode
+// Output: one CSV line per image size and mode (width,height,mode,objects,mean_ms)
+
+#include <opencv2/opencv.hpp>
+#include <iostream>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include "../main/ImageSource.hpp"
+#include "../main/ObjectDetection.hpp"
+#include "SyntheticImage.hpp"
+using namespace cv;
+
+int main(int argc, char** argv) {
+    std::string directory = argc > 1 ? argv[1] : ".";
+    int repetitions = argc > 2 ? std::atoi(argv[2]) : 10;
+
+    if (repetitions < 1) {
+        std::cerr << "Usage: bench_decode [directory] [repetitions >= 1]" << std::endl;
+        return 1;
+    }
+
+    const cv::Size sizes[] = { cv::Size(1920, 1080), cv::Size(4000, 3000), cv::Size(8000, 6000) };
+
+    std::cout << "width,height,mode,objects,mean_ms" << std::endl;
+
+    for (const cv::Size& size : sizes) {
+        std::string path = directory + "/bench_decode_" + std::to_string(size.width) + "x" + std::to_string(size.height) + ".jpg";
+        if (!cv::imwrite(path, createSyntheticImage(size.width, size.height, 120))) {
+            std::cerr << "Error: Could not write " << path << std::endl;
+            return 1;
+        }
+
+        ObjectDetection detection;
+
+        // Mode name, request, and whether the cache may serve the reads
+        struct Mode {
+            const char* name;
+            bool color;
+            int maxReduction;
+            bool cached;
+        };
+        const Mode modes[] = {
+            { "color", true, 1, false },
+            { "grayscale", false, 1, false },
+            { "grayscale_reduced_2", false, 2, false },
+            { "grayscale_reduced_4", false, 4, false },
+            { "color_cached", true, 1, true },
+        };
+
+        double imreadMs = 0;
+        for (int i = 0; i < repetitions; i++) {
+            auto start = std::chrono::high_resolution_clock::now();
+            cv::Mat image = cv::imread(path, cv::IMREAD_COLOR);
+            auto end = std::chrono::high_resolution_clock::now();
+            imreadMs += std::chrono::duration<double, std::milli>(end - start).count();
+        }
+        std::cout << size.width << "," << size.height << ",imread," << detection.analyze(cv::imread(path)).getObjectCount()
+            << "," << imreadMs / repetitions << std::endl;
+
+        for (const Mode& mode : modes) {
+            DecodeRequest request;
+            request.color = mode.color;
+            request.maxReduction = mode.maxReduction;
+
+            ImageSource images(mode.cached ? 1024 * 1024 * 1024 : 0);
+            cv::Mat image = images.read(path, request);
+
+            double totalMs = 0;
+            for (int i = 0; i < repetitions; i++) {
+                auto start = std::chrono::high_resolution_clock::now();
+                image = images.read(path, request);
+                auto end = std::chrono::high_resolution_clock::now();
+                totalMs += std::chrono::duration<double, std::milli>(end - start).count();
+            }
+
+            std::cout << size.width << "," << size.height << "," << mode.name << "," << detection.analyze(image).getObjectCount()
+                << "," << totalMs / repetitions << std::endl;
+        }
+
+        std::remove(path.c_str());
+    }
+
+    return 0;
+}
@@ -0,0 +1,58 @@
+// Compares dilateSquare with radius N against cv::dilate with the (2N + 1) square element in one pass,
+// which is what cv::dilate makes of N iterations with the default 3x3 element, on synthetic edge maps up
+// to 48 megapixels, and checks that both give the same result. cv::dilate's separable rect filter does
+// 2N + 1 comparisons per pixel and direction and the max filter about three, so the max filter's time
+// should stay flat while cv::dilate's grows with N. The radii follow the pipeline's
+// 2 + (rows + cols) / 1500 and a few larger ones.
+//
+// Build: cmake -S .. -B build && cmake --build build --target bench_dilate
+// Output: megapixels,radius,dilate_ms,max_filter_ms,speedup
+
+#include <opencv2/opencv.hpp>
+#include <iostream>
+#include <chrono>
+#include "../main/MaxFilter.hpp"
+#include "SyntheticImage.hpp"
+using namespace cv;
+
+int main() {
+    const int sizes[][2] = { { 1600, 1200 }, { 4000, 3000 }, { 8000, 6000 } };
+    const int runs = 3;
+
+    std::cout << "megapixels,radius,dilate_ms,max_filter_ms,speedup" << std::endl;
+
+    for (const auto& size : sizes) {
+        cv::Mat image = createSyntheticImage(size[0], size[1], 120);
+        cv::Mat gray, edges;
+        cv::cvtColor(image, gray, cv::COLOR_BGR2GRAY);
+        cv::Canny(gray, edges, 50, 135);
+
+        int pipelineIterations = 2 + ((edges.rows + edges.cols) / 1500);
+        for (int radius : { pipelineIterations, 2 * pipelineIterations, 4 * pipelineIterations }) {
+            cv::Mat reference, filtered;
+            cv::Mat element = cv::getStructuringElement(cv::MORPH_RECT, cv::Size(2 * radius + 1, 2 * radius + 1));
+
+            auto start = std::chrono::high_resolution_clock::now();
+            for (int i = 0; i < runs; i++) {
+                cv::dilate(edges, reference, element);
+            }
+            auto middle = std::chrono::high_resolution_clock::now();
+            for (int i = 0; i < runs; i++) {
+                dilateSquare(edges, filtered, radius);
+            }
+            auto end = std::chrono::high_resolution_clock::now();
+
+            if (cv::norm(reference, filtered, cv::NORM_INF) != 0) {
+                std::cerr << "Error: dilation differs at " << size[0] << "x" << size[1] << " with radius " << radius << std::endl;
+                return 1;
+            }
+
+            double dilateMs = std::chrono::duration<double, std::milli>(middle - start).count() / runs;
+            double filterMs = std::chrono::duration<double, std::milli>(end - middle).count() / runs;
+
+            std::cout << (size[0] * size[1]) / 1e6 << "," << radius << "," << dilateMs << "," << filterMs << "," << dilateMs / filterMs << std::endl;
+        }
+    }
+
+    return 0;
+}
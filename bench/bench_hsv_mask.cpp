@@ -0,0 +1,61 @@
+// Compares the original wrapped-hue segmentation (two cvtColor + inRange passes, OR, then
+// bitwise_and) with HSVRangeMask, and checks that mask and masked image match exactly.
+//
+// Build: cmake -S .. -B build && cmake --build build --target bench_hsv_mask
+// Output: one CSV line per image size (megapixels,reference_ms,lookup_ms,speedup). Every image gets a
+//   new HSVRangeMask, as when a program segments a single image, and lookup_ms includes building it.
+
+#include <opencv2/opencv.hpp>
+#include <iostream>
+#include <chrono>
+#include "../main/HSVRangeMask.hpp"
+#include "SyntheticImage.hpp"
+using namespace cv;
+
+void referenceSegmentation(const cv::Mat& image, cv::Mat& mask, cv::Mat& masked) {
+    cv::Mat hsv1, hsv2, mask1, mask2;
+
+    // Hue 2 +/- 3 wraps around red into 177-179
+    cv::cvtColor(image, hsv1, cv::COLOR_BGR2HSV);
+    cv::inRange(hsv1, cv::Scalar(0, 100, 0), cv::Scalar(5, 255, 255), mask1);
+    cv::cvtColor(image, hsv2, cv::COLOR_BGR2HSV);
+    cv::inRange(hsv2, cv::Scalar(179, 100, 0), cv::Scalar(180, 255, 255), mask2);
+
+    mask = mask1 | mask2;
+
+    masked.release();
+    cv::bitwise_and(image, image, masked, mask);
+}
+
+int main() {
+    const cv::Size sizes[] = { cv::Size(640, 480), cv::Size(1920, 1080), cv::Size(4000, 3000), cv::Size(8000, 6000) };
+
+    std::cout << "megapixels,reference_ms,lookup_ms,speedup" << std::endl;
+
+    for (const cv::Size& size : sizes) {
+        // Random colours so every hue, including both sides of red, shows up
+        cv::Mat image(size, CV_8UC3);
+        cv::randu(image, cv::Scalar::all(0), cv::Scalar::all(256));
+
+        cv::Mat referenceMask, referenceMasked, mask, masked;
+
+        auto start = std::chrono::high_resolution_clock::now();
+        referenceSegmentation(image, referenceMask, referenceMasked);
+        auto middle = std::chrono::high_resolution_clock::now();
+        HSVRangeMask hsvMask({ HueRange::around(2, 3) }, 100, 255, 0, 255);
+        hsvMask.apply(image, mask, masked);
+        auto end = std::chrono::high_resolution_clock::now();
+
+        if (cv::norm(referenceMask, mask, cv::NORM_INF) != 0 || cv::norm(referenceMasked, masked, cv::NORM_INF) != 0) {
+            std::cerr << "Error: lookup mask differs from the reference" << std::endl;
+            return 1;
+        }
+
+        double referenceMs = std::chrono::duration<double, std::milli>(middle - start).count();
+        double lookupMs = std::chrono::duration<double, std::milli>(end - middle).count();
+
+        std::cout << size.area() / 1e6 << "," << referenceMs << "," << lookupMs << "," << referenceMs / lookupMs << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,129 @@
+// Compares nearest, k-nearest and rectangle queries answered by scanning every object with
+// the same queries answered by ObjectIndex, on dense synthetic images with thousands of objects.
+// Every query must give the same objects on both paths.
+//
+// Usage: bench_object_index [spacing] [queries] [k]
+//   spacing  distance between synthetic objects in pixels, smaller is denser (default 40)
+//   queries  random query points and rectangles per image (default 10000)
+//   k        neighbours per k-nearest query (default 8)
+//
+// Build: cmake -S .. -B build && cmake --build build --target bench_object_index
+// Output: one CSV line per image size and query type (width,height,objects,query,build_ms,scan_ms,index_ms,speedup)
+
+#include <opencv2/opencv.hpp>
+#include <iostream>
+#include <chrono>
+#include <algorithm>
+#include <functional>
+#include <cstdlib>
+#include "../main/ObjectDetection.hpp"
+#include "../main/ObjectIndex.hpp"
+#include "SyntheticImage.hpp"
+using namespace cv;
+
+// k nearest by sorting every object, ties to the lower index
+std::vector<int> scanNearest(const FrameAnalysis& analysis, cv::Point2f point, int k) {
+    std::vector<std::pair<float, int>> distances;
+    for (int i = 0; i < analysis.getObjectCount(); i++) {
+        distances.emplace_back(static_cast<float>(cv::norm(point - analysis.getCentroid(i))), i);
+    }
+
+    size_t count = std::min(distances.size(), static_cast<size_t>(k));
+    std::partial_sort(distances.begin(), distances.begin() + count, distances.end());
+
+    std::vector<int> nearest;
+    for (size_t i = 0; i < count; i++) {
+        nearest.push_back(distances[i].second);
+    }
+    return nearest;
+}
+
+std::vector<int> scanOverlapping(const FrameAnalysis& analysis, const cv::Rect& rect) {
+    std::vector<int> overlapping;
+    for (int i = 0; i < analysis.getObjectCount(); i++) {
+        if ((analysis.getBoundingBox(i) & rect).area() > 0) {
+            overlapping.push_back(i);
+        }
+    }
+    return overlapping;
+}
+
+int main(int argc, char** argv) {
+    int spacing = argc > 1 ? std::atoi(argv[1]) : 40;
+    int queries = argc > 2 ? std::atoi(argv[2]) : 10000;
+    int k = argc > 3 ? std::atoi(argv[3]) : 8;
+
+    if (spacing < 10 || queries < 1 || k < 1) {
+        std::cerr << "Usage: bench_object_index [spacing >= 10] [queries >= 1] [k >= 1]" << std::endl;
+        return 1;
+    }
+
+    const cv::Size sizes[] = { cv::Size(1920, 1080), cv::Size(4000, 3000), cv::Size(8000, 6000) };
+
+    std::cout << "width,height,objects,query,build_ms,scan_ms,index_ms,speedup" << std::endl;
+
+    for (const cv::Size& size : sizes) {
+        ObjectDetection detection;
+        FrameAnalysis analysis = detection.analyze(createSyntheticImage(size.width, size.height, spacing));
+
+        auto start = std::chrono::high_resolution_clock::now();
+        ObjectIndex index(analysis);
+        auto end = std::chrono::high_resolution_clock::now();
+        double buildMs = std::chrono::duration<double, std::milli>(end - start).count();
+
+        if (index.findCenterObject() != analysis.findCenterObject()) {
+            std::cerr << "Error: center object differs" << std::endl;
+            return 1;
+        }
+
+        cv::RNG rng(42);
+        std::vector<cv::Point2f> points;
+        std::vector<cv::Rect> rects;
+        for (int i = 0; i < queries; i++) {
+            points.push_back(cv::Point2f(rng.uniform(0.f, static_cast<float>(size.width)), rng.uniform(0.f, static_cast<float>(size.height))));
+            rects.push_back(cv::Rect(rng.uniform(0, size.width), rng.uniform(0, size.height), rng.uniform(1, 200), rng.uniform(1, 200)));
+        }
+
+        // Query type, then the scan and index answers for query i
+        struct QueryType {
+            const char* name;
+            std::function<std::vector<int>(int)> scan;
+            std::function<std::vector<int>(int)> indexed;
+        };
+        std::vector<QueryType> types = {
+            { "nearest", [&](int i) { return scanNearest(analysis, points[i], 1); },
+                [&](int i) { return std::vector<int>(1, index.findNearest(points[i])); } },
+            { "k_nearest", [&](int i) { return scanNearest(analysis, points[i], k); },
+                [&](int i) { return index.findNearest(points[i], k); } },
+            { "rectangle", [&](int i) { return scanOverlapping(analysis, rects[i]); },
+                [&](int i) { return index.findOverlapping(rects[i]); } },
+        };
+
+        for (const QueryType& type : types) {
+            std::vector<std::vector<int>> scanned(queries);
+            std::vector<std::vector<int>> indexed(queries);
+
+            auto scanStart = std::chrono::high_resolution_clock::now();
+            for (int i = 0; i < queries; i++) {
+                scanned[i] = type.scan(i);
+            }
+            auto indexStart = std::chrono::high_resolution_clock::now();
+            for (int i = 0; i < queries; i++) {
+                indexed[i] = type.indexed(i);
+            }
+            auto indexEnd = std::chrono::high_resolution_clock::now();
+
+            if (scanned != indexed) {
+                std::cerr << "Error: " << type.name << " queries differ at " << size.width << "x" << size.height << std::endl;
+                return 1;
+            }
+
+            double scanMs = std::chrono::duration<double, std::milli>(indexStart - scanStart).count();
+            double indexMs = std::chrono::duration<double, std::milli>(indexEnd - indexStart).count();
+            std::cout << size.width << "," << size.height << "," << analysis.getObjectCount() << "," << type.name << ","
+                << buildMs << "," << scanMs << "," << indexMs << "," << scanMs / indexMs << std::endl;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,72 @@
+// Compares the original full-frame drawWeightedContour (full-size mask, clone, addWeighted over
+// every pixel, once per contour) with OverlayRenderer for a growing number of highlighted objects,
+// and checks that both produce the same image bit for bit.
+//
+// Build: cmake -S .. -B build && cmake --build build --target bench_overlay
+// Output: one CSV line per contour count (contours,reference_ms,renderer_ms,speedup)
+
+#include <opencv2/opencv.hpp>
+#include <iostream>
+#include <chrono>
+#include <cstdlib>
+#include "../main/ObjectDetection.hpp"
+#include "../main/OverlayRenderer.hpp"
+#include "SyntheticImage.hpp"
+using namespace cv;
+
+void referenceOverlay(cv::Mat image, const std::vector<std::vector<cv::Point>>& contours, int index, const cv::Scalar& color) {
+    cv::Mat mask = cv::Mat::zeros(image.size(), CV_8UC1);
+    cv::drawContours(mask, contours, index, cv::Scalar(255), cv::FILLED);
+
+    cv::Mat overlayedImage = image.clone();
+    overlayedImage.setTo(color, mask);
+
+    double alpha = 0.4;
+    cv::addWeighted(overlayedImage, alpha, image, 1.0 - alpha, 0, image);
+    cv::drawContours(image, contours, index, color, 1 + ((image.rows + image.cols) / 400));
+}
+
+int main(int argc, char** argv) {
+    int width = argc > 1 ? std::atoi(argv[1]) : 4000;
+    int height = argc > 2 ? std::atoi(argv[2]) : 3000;
+
+    cv::Mat image = createSyntheticImage(width, height, 120);
+
+    ObjectDetection detection;
+    FrameAnalysis analysis = detection.analyze(image);
+    const std::vector<std::vector<cv::Point>>& contours = analysis.getContours();
+
+    OverlayRenderer renderer;
+
+    std::cout << "contours,reference_ms,renderer_ms,speedup" << std::endl;
+
+    for (int count = 1; count <= analysis.getObjectCount(); count *= 10) {
+        std::vector<int> indices;
+        for (int i = 0; i < count; i++) {
+            indices.push_back(i);
+        }
+
+        cv::Mat reference = image.clone();
+        cv::Mat rendered = image.clone();
+
+        auto start = std::chrono::high_resolution_clock::now();
+        for (int index : indices) {
+            referenceOverlay(reference, contours, index, renderer.color);
+        }
+        auto middle = std::chrono::high_resolution_clock::now();
+        renderer.draw(rendered, contours, indices);
+        auto end = std::chrono::high_resolution_clock::now();
+
+        if (cv::norm(reference, rendered, cv::NORM_INF) != 0) {
+            std::cerr << "Error: overlay differs from the reference for " << count << " contours" << std::endl;
+            return 1;
+        }
+
+        double referenceMs = std::chrono::duration<double, std::milli>(middle - start).count();
+        double rendererMs = std::chrono::duration<double, std::milli>(end - middle).count();
+
+        std::cout << count << "," << referenceMs << "," << rendererMs << "," << referenceMs / rendererMs << std::endl;
+    }
+
+    return 0;
+}
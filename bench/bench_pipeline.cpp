@@ -0,0 +1,193 @@
+// Times every stage of the detection pipeline on its own, and every public ObjectDetection
+// method end to end, on synthetic images of 0.3, 2, 12 and 48 megapixels.
+//
+// Usage: bench_pipeline [spacing] [repetitions] [max_megapixels]
+//   spacing         distance between synthetic objects in pixels, smaller is denser (default 120)
+//   repetitions     timed runs per benchmark after one warm-up run (default 10)
+//   max_megapixels  skip larger images (default 48)
+//
+// Build: cmake -S .. -B build && cmake --build build --target bench_pipeline
+// Output: one CSV line per image size and benchmark
+//   (megapixels,width,height,spacing,objects,benchmark,repetitions,min_ms,median_ms,mean_ms)
+
+#include <opencv2/opencv.hpp>
+#include <iostream>
+#include <chrono>
+#include <functional>
+#include <algorithm>
+#include <numeric>
+#include <cstdlib>
+#include "../main/ObjectDetection.hpp"
+#include "SyntheticImage.hpp"
+using namespace cv;
+
+struct BenchmarkTiming {
+    double minMs;
+    double medianMs;
+    double meanMs;
+};
+
+// Runs setup untimed before every repetition, then times run; the first repetition is a warm-up
+BenchmarkTiming measure(int repetitions, const std::function<void()>& setup, const std::function<void()>& run) {
+    std::vector<double> times;
+
+    for (int i = 0; i <= repetitions; i++) {
+        setup();
+
+        auto start = std::chrono::high_resolution_clock::now();
+        run();
+        auto end = std::chrono::high_resolution_clock::now();
+
+        if (i > 0) {
+            times.push_back(std::chrono::duration<double, std::milli>(end - start).count());
+        }
+    }
+
+    std::sort(times.begin(), times.end());
+
+    BenchmarkTiming timing;
+    timing.minMs = times.front();
+    timing.medianMs = times[times.size() / 2];
+    timing.meanMs = std::accumulate(times.begin(), times.end(), 0.0) / times.size();
+
+    return timing;
+}
+
+int main(int argc, char** argv) {
+    int spacing = argc > 1 ? std::atoi(argv[1]) : 120;
+    int repetitions = argc > 2 ? std::atoi(argv[2]) : 10;
+    double maxMegapixels = argc > 3 ? std::atof(argv[3]) : 48;
+
+    if (spacing < 10 || repetitions < 1) {
+        std::cerr << "Usage: bench_pipeline [spacing >= 10] [repetitions >= 1] [max_megapixels]" << std::endl;
+        return 1;
+    }
+
+    // 0.3, 2, 12 and 48 megapixels
+    const cv::Size sizes[] = { cv::Size(640, 480), cv::Size(1920, 1080), cv::Size(4000, 3000), cv::Size(8000, 6000) };
+
+    std::cout << "megapixels,width,height,spacing,objects,benchmark,repetitions,min_ms,median_ms,mean_ms" << std::endl;
+
+    for (const cv::Size& size : sizes) {
+        double megapixels = size.area() / 1e6;
+        if (megapixels > maxMegapixels) {
+            continue;
+        }
+
+        cv::Mat image = createSyntheticImage(size.width, size.height, spacing);
+        int iterations = 2 + ((image.rows + image.cols) / 1500);
+
+        // Same defaults as the pipeline in ObjectDetection and EdgePreprocessor
+        EdgePreprocessor settings;
+        const double minArea = 2000;
+
+        ObjectDetection detection;
+        FrameAnalysis analysis = detection.analyze(image);
+
+        // Query points at the center of the first object and on the background
+        cv::Point hit = analysis.empty() ? cv::Point(0, 0) : cv::Point(analysis.getCentroid(0));
+        cv::Point miss(0, 0);
+
+        cv::RNG rng(42);
+        std::vector<cv::Point> points;
+        for (int i = 0; i < 1000; i++) {
+            points.push_back(cv::Point(rng.uniform(0, size.width), rng.uniform(0, size.height)));
+        }
+
+        // Intermediate results of each stage, so the next stage can be timed on its real input
+        cv::Mat gray, blurred, edges, dilatedEdges, fused, canvas;
+        std::vector<std::vector<cv::Point>> contours;
+        std::vector<std::vector<cv::Point>> filtered;
+        std::vector<double> areas;
+        std::string text;
+        int result = 0;
+
+        auto noSetup = []() {};
+        auto freshCanvas = [&]() { image.copyTo(canvas); };
+
+        std::vector<std::pair<std::string, BenchmarkTiming>> timings;
+
+        // Pipeline stages
+        timings.emplace_back("stage_gray", measure(repetitions, noSetup, [&]() {
+            cv::cvtColor(image, gray, cv::COLOR_BGR2GRAY);
+        }));
+        timings.emplace_back("stage_blur", measure(repetitions, noSetup, [&]() {
+            cv::GaussianBlur(gray, blurred, settings.blurSize, settings.blurSigma, settings.blurSigma);
+        }));
+        timings.emplace_back("stage_canny", measure(repetitions, noSetup, [&]() {
+            cv::Canny(blurred, edges, settings.cannyThreshold1, settings.cannyThreshold2);
+        }));
+        timings.emplace_back("stage_dilate", measure(repetitions, noSetup, [&]() {
+            cv::dilate(edges, dilatedEdges, cv::Mat(), cv::Point(-1, -1), iterations);
+        }));
+        timings.emplace_back("stage_preprocess_fused", measure(repetitions, noSetup, [&]() {
+            detection.getEdges(image).copyTo(fused);
+        }));
+        timings.emplace_back("stage_find_contours", measure(repetitions, noSetup, [&]() {
+            cv::findContours(dilatedEdges, contours, cv::RETR_EXTERNAL, cv::CHAIN_APPROX_SIMPLE);
+        }));
+        timings.emplace_back("stage_area_filter", measure(repetitions, noSetup, [&]() {
+            filtered.clear();
+            areas.clear();
+            for (const auto& contour : contours) {
+                double area = cv::contourArea(contour);
+                if (area >= minArea) {
+                    filtered.push_back(contour);
+                    areas.push_back(area);
+                }
+            }
+        }));
+        timings.emplace_back("stage_centroid_selection", measure(repetitions, noSetup, [&]() {
+            result = FrameAnalysis(image.size(), filtered, areas).findCenterObject();
+        }));
+        timings.emplace_back("stage_draw_weighted_contour", measure(repetitions, freshCanvas, [&]() {
+            detection.identifyCenterObject(canvas, analysis);
+        }));
+
+        // Public ObjectDetection methods, each running the whole pipeline
+        timings.emplace_back("analyze", measure(repetitions, noSetup, [&]() {
+            detection.analyze(image, analysis);
+        }));
+        timings.emplace_back("analyzeAround", measure(repetitions, noSetup, [&]() {
+            result = detection.analyzeAround(image, hit).getObjectCount();
+        }));
+        timings.emplace_back("identifyCenterObject", measure(repetitions, freshCanvas, [&]() {
+            detection.identifyCenterObject(canvas);
+        }));
+        timings.emplace_back("identifyCenterObjectArea", measure(repetitions, noSetup, [&]() {
+            result = detection.identifyCenterObjectArea(image);
+        }));
+        timings.emplace_back("findCenterOfObject", measure(repetitions, noSetup, [&]() {
+            text = detection.findCenterOfObject(image);
+        }));
+        timings.emplace_back("findObject", measure(repetitions, freshCanvas, [&]() {
+            detection.findObject(canvas, hit.x, hit.y);
+        }));
+        timings.emplace_back("findObjectArea_hit", measure(repetitions, noSetup, [&]() {
+            result = detection.findObjectArea(image, hit.x, hit.y);
+        }));
+        timings.emplace_back("findObjectArea_miss", measure(repetitions, noSetup, [&]() {
+            result = detection.findObjectArea(image, miss.x, miss.y);
+        }));
+        timings.emplace_back("findObjects_1000", measure(repetitions, noSetup, [&]() {
+            result = static_cast<int>(detection.findObjects(image, points).size());
+        }));
+        timings.emplace_back("findObjectInfo", measure(repetitions, freshCanvas, [&]() {
+            detection.findObjectInfo(canvas, hit.x, hit.y);
+        }));
+        timings.emplace_back("centerObjectInfo", measure(repetitions, freshCanvas, [&]() {
+            detection.centerObjectInfo(canvas);
+        }));
+        timings.emplace_back("getEdges", measure(repetitions, noSetup, [&]() {
+            fused = detection.getEdges(image);
+        }));
+
+        for (const auto& timing : timings) {
+            std::cout << megapixels << "," << size.width << "," << size.height << "," << spacing << ","
+                << analysis.getObjectCount() << "," << timing.first << "," << repetitions << ","
+                << timing.second.minMs << "," << timing.second.medianMs << "," << timing.second.meanMs << std::endl;
+        }
+    }
+
+    return 0;
+}
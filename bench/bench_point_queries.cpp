@@ -0,0 +1,57 @@
+// Compares resolving query points one by one with pointPolygonTest against the
+// label-map backed FrameAnalysis::findObjectsAt, for a growing number of points.
+//
+// Build: cmake -S .. -B build && cmake --build build --target bench_point_queries
+// Output: one CSV line per point count (points,loop_ms,batch_ms,speedup)
+
+#include <opencv2/opencv.hpp>
+#include <iostream>
+#include <chrono>
+#include <cstdlib>
+#include "../main/ObjectDetection.hpp"
+#include "SyntheticImage.hpp"
+using namespace cv;
+
+int main(int argc, char** argv) {
+    int width = argc > 1 ? std::atoi(argv[1]) : 4000;
+    int height = argc > 2 ? std::atoi(argv[2]) : 3000;
+
+    cv::Mat image = createSyntheticImage(width, height, 120);
+
+    ObjectDetection detection;
+    FrameAnalysis analysis = detection.analyze(image);
+
+    std::cerr << "Objects: " << analysis.getObjectCount() << std::endl;
+    std::cout << "points,loop_ms,batch_ms,speedup" << std::endl;
+
+    cv::RNG rng(42);
+    for (int count = 1; count <= 4096; count *= 4) {
+        std::vector<cv::Point> points;
+        for (int i = 0; i < count; i++) {
+            points.push_back(cv::Point(rng.uniform(0, width), rng.uniform(0, height)));
+        }
+
+        auto start = std::chrono::high_resolution_clock::now();
+        std::vector<int> loopIds;
+        for (const auto& point : points) {
+            loopIds.push_back(analysis.findObjectAt(point));
+        }
+        auto middle = std::chrono::high_resolution_clock::now();
+        std::vector<PointQueryResult> results = analysis.findObjectsAt(points);
+        auto end = std::chrono::high_resolution_clock::now();
+
+        for (size_t i = 0; i < points.size(); i++) {
+            if (results[i].objectId != loopIds[i]) {
+                std::cerr << "Error: mismatch at point (" << points[i].x << ", " << points[i].y << ")" << std::endl;
+                return 1;
+            }
+        }
+
+        double loopMs = std::chrono::duration<double, std::milli>(middle - start).count();
+        double batchMs = std::chrono::duration<double, std::milli>(end - middle).count();
+
+        std::cout << count << "," << loopMs << "," << batchMs << "," << loopMs / batchMs << std::endl;
+    }
+
+    return 0;
+}
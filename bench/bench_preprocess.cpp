@@ -0,0 +1,68 @@
+// Compares the original full-frame cvtColor, GaussianBlur, Canny, dilate sequence with
+// EdgePreprocessor and checks that both produce the same edge map bit for bit.
+//
+// Build: cmake -S .. -B build && cmake --build build --target bench_preprocess
+// Output: one CSV line per image size (megapixels,reference_ms,fused_ms,speedup)
+
+#include <opencv2/opencv.hpp>
+#include <iostream>
+#include <chrono>
+#include "../main/EdgePreprocessor.hpp"
+#include "SyntheticImage.hpp"
+using namespace cv;
+
+cv::Mat referenceEdges(const cv::Mat& image, int iterations) {
+    cv::Mat gray;
+    cv::cvtColor(image, gray, cv::COLOR_BGR2GRAY);
+
+    cv::Mat blurredImage;
+    cv::GaussianBlur(gray, blurredImage, cv::Size(1, 1), 0, 0);
+
+    cv::Mat edges;
+    cv::Canny(blurredImage, edges, 50, 135);
+
+    cv::Mat dilatedEdges;
+    cv::dilate(edges, dilatedEdges, cv::Mat(), cv::Point(-1, -1), iterations);
+
+    return dilatedEdges;
+}
+
+int main() {
+    const int sizes[][2] = { { 640, 480 }, { 1600, 1200 }, { 4000, 3000 }, { 6000, 4000 } };
+    const int runs = 5;
+
+    std::cout << "megapixels,reference_ms,fused_ms,speedup" << std::endl;
+
+    EdgePreprocessor preprocessor;
+    cv::Mat fused;
+
+    for (const auto& size : sizes) {
+        cv::Mat image = createSyntheticImage(size[0], size[1], 120);
+        int iterations = 2 + ((image.rows + image.cols) / 1500);
+
+        cv::Mat reference = referenceEdges(image, iterations);
+        preprocessor.process(image, fused, iterations);
+
+        if (cv::norm(reference, fused, cv::NORM_INF) != 0) {
+            std::cerr << "Error: edge maps differ at " << size[0] << "x" << size[1] << std::endl;
+            return 1;
+        }
+
+        auto start = std::chrono::high_resolution_clock::now();
+        for (int i = 0; i < runs; i++) {
+            reference = referenceEdges(image, iterations);
+        }
+        auto middle = std::chrono::high_resolution_clock::now();
+        for (int i = 0; i < runs; i++) {
+            preprocessor.process(image, fused, iterations);
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+
+        double referenceMs = std::chrono::duration<double, std::milli>(middle - start).count() / runs;
+        double fusedMs = std::chrono::duration<double, std::milli>(end - middle).count() / runs;
+
+        std::cout << (size[0] * size[1]) / 1e6 << "," << referenceMs << "," << fusedMs << "," << referenceMs / fusedMs << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,101 @@
+// Compares full-resolution center-object and point queries with the coarse-to-fine pyramid mode on
+// large synthetic captures, and reports how far the pyramid answers are from the full-frame ones.
+// Errors are taken over every query: relative area error and centroid distance in pixels, plus the
+// number of queries where the pyramid picked a different object or none.
+//
+// Build: cmake -S .. -B build && cmake --build build --target bench_pyramid
+// Output: one CSV line per image size and level
+//   (megapixels,levels,query,full_ms,pyramid_ms,speedup,max_area_error,max_centroid_error_px,mismatches)
+
+#include <opencv2/opencv.hpp>
+#include <iostream>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include "../main/ObjectDetection.hpp"
+#include "SyntheticImage.hpp"
+using namespace cv;
+
+struct QueryErrors {
+    double maxAreaError = 0;
+    double maxCentroidError = 0;
+    int mismatches = 0;
+};
+
+// Compares the object a pyramid query found with the full-frame one
+void compareQuery(const FrameAnalysis& full, int fullIndex, const FrameAnalysis& pyramid, int pyramidIndex, QueryErrors& errors) {
+    if ((fullIndex < 0) != (pyramidIndex < 0)) {
+        errors.mismatches++;
+        return;
+    }
+    if (fullIndex < 0) {
+        return;
+    }
+
+    double areaError = std::abs(pyramid.getArea(pyramidIndex) - full.getArea(fullIndex)) / full.getArea(fullIndex);
+    double centroidError = cv::norm(pyramid.getCentroid(pyramidIndex) - full.getCentroid(fullIndex));
+
+    // A different object shows up as a centroid far outside the original one
+    if (!full.getBoundingBox(fullIndex).contains(cv::Point(pyramid.getCentroid(pyramidIndex)))) {
+        errors.mismatches++;
+        return;
+    }
+
+    errors.maxAreaError = std::max(errors.maxAreaError, areaError);
+    errors.maxCentroidError = std::max(errors.maxCentroidError, centroidError);
+}
+
+int main(int argc, char** argv) {
+    int spacing = argc > 1 ? std::atoi(argv[1]) : 160;
+    int clicks = argc > 2 ? std::atoi(argv[2]) : 20;
+
+    // 24 and 48 megapixels
+    const cv::Size sizes[] = { cv::Size(6000, 4000), cv::Size(8000, 6000) };
+
+    std::cout << "megapixels,levels,query,full_ms,pyramid_ms,speedup,max_area_error,max_centroid_error_px,mismatches" << std::endl;
+
+    for (const cv::Size& size : sizes) {
+        cv::Mat image = createSyntheticImage(size.width, size.height, spacing);
+
+        ObjectDetection detection;
+        FrameAnalysis full, pyramid;
+
+        auto start = std::chrono::high_resolution_clock::now();
+        detection.analyze(image, full);
+        int fullCenter = full.findCenterObject();
+        auto end = std::chrono::high_resolution_clock::now();
+        double fullMs = std::chrono::duration<double, std::milli>(end - start).count();
+
+        cv::RNG rng(42);
+        std::vector<cv::Point> points;
+        for (int i = 0; i < clicks; i++) {
+            points.push_back(cv::Point(rng.uniform(0, size.width), rng.uniform(0, size.height)));
+        }
+
+        for (int levels = 1; levels <= 3; levels++) {
+            QueryErrors centerErrors;
+            start = std::chrono::high_resolution_clock::now();
+            detection.analyzeCenterPyramid(image, pyramid, levels);
+            end = std::chrono::high_resolution_clock::now();
+            double centerMs = std::chrono::duration<double, std::milli>(end - start).count();
+            compareQuery(full, fullCenter, pyramid, pyramid.empty() ? -1 : 0, centerErrors);
+
+            // Point queries against a full-frame analysis done once for all clicks
+            QueryErrors pointErrors;
+            start = std::chrono::high_resolution_clock::now();
+            for (const cv::Point& point : points) {
+                detection.analyzeAroundPyramid(image, point, pyramid, levels);
+                compareQuery(full, full.findObjectAt(point), pyramid, pyramid.findObjectAt(point), pointErrors);
+            }
+            end = std::chrono::high_resolution_clock::now();
+            double pointMs = std::chrono::duration<double, std::milli>(end - start).count() / clicks;
+
+            std::cout << size.area() / 1e6 << "," << levels << ",center," << fullMs << "," << centerMs << "," << fullMs / centerMs << ","
+                << centerErrors.maxAreaError << "," << centerErrors.maxCentroidError << "," << centerErrors.mismatches << std::endl;
+            std::cout << size.area() / 1e6 << "," << levels << ",point," << fullMs << "," << pointMs << "," << fullMs / pointMs << ","
+                << pointErrors.maxAreaError << "," << pointErrors.maxCentroidError << "," << pointErrors.mismatches << std::endl;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,84 @@
+// Times writing one million image results, each with one object record, as CSV through an
+// std::ostream (the way batch writes it), and as JSON lines and binary through ResultWriter.
+//
+// Usage: bench_result_writer [directory] [images]
+//   directory  where the temporary output files are written (default .)
+//   images     image results per format (default 1000000)
+//
+// Build: cmake -S .. -B build && cmake --build build --target bench_result_writer
+// Output: one CSV line per format (format,images,bytes,ms,records_per_second)
+
+#include <opencv2/opencv.hpp>
+#include <iostream>
+#include <fstream>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include "../main/ResultWriter.hpp"
+#include "../main/ObjectDetection.hpp"
+#include "SyntheticImage.hpp"
+using namespace cv;
+
+int main(int argc, char** argv) {
+    std::string directory = argc > 1 ? argv[1] : ".";
+    int images = argc > 2 ? std::atoi(argv[2]) : 1000000;
+
+    if (images < 1) {
+        std::cerr << "Usage: bench_result_writer [directory] [images >= 1]" << std::endl;
+        return 1;
+    }
+
+    // Records of real objects, reused for every image
+    ObjectDetection detection;
+    FrameAnalysis analysis = detection.analyze(createSyntheticImage(640, 480, 120));
+    if (analysis.empty()) {
+        std::cerr << "Error: No objects in the synthetic image" << std::endl;
+        return 1;
+    }
+
+    std::string imagePath = "C:/Users/Sebastian WL/Desktop/Images/blood_000000.jpg";
+    const char* formats[] = { "csv", "jsonl", "binary" };
+
+    std::cout << "format,images,bytes,ms,records_per_second" << std::endl;
+
+    for (const char* format : formats) {
+        std::string path = directory + "/bench_result_writer." + format;
+        std::ofstream output(path, std::ios::out | std::ios::binary);
+        if (!output.is_open()) {
+            std::cerr << "Error: Could not open " << path << std::endl;
+            return 1;
+        }
+
+        auto start = std::chrono::high_resolution_clock::now();
+
+        if (std::string(format) == "csv") {
+            output << "path,objects,area,center_x,center_y" << "\n";
+            for (int i = 0; i < images; i++) {
+                int index = i % analysis.getObjectCount();
+                cv::Point2f center = analysis.getCentroid(index);
+                output << imagePath << "," << analysis.getObjectCount() << "," << analysis.getArea(index) << ","
+                    << static_cast<int>(center.x) << "," << static_cast<int>(center.y) << "\n";
+            }
+            output.flush();
+        }
+        else {
+            ResultWriter writer(output, std::string(format) == "binary" ? ResultFormat::Binary : ResultFormat::JsonLines);
+            for (int i = 0; i < images; i++) {
+                int index = i % analysis.getObjectCount();
+                writer.writeImage(static_cast<uint32_t>(i), imagePath, true, analysis.getObjectCount());
+                writer.writeObject(analysis.getRecord(index, static_cast<uint32_t>(i)));
+            }
+            writer.flush();
+        }
+
+        auto end = std::chrono::high_resolution_clock::now();
+        double ms = std::chrono::duration<double, std::milli>(end - start).count();
+        std::streamoff bytes = output.tellp();
+        output.close();
+        std::remove(path.c_str());
+
+        std::cout << format << "," << images << "," << bytes << "," << ms << "," << images / (ms / 1000) << std::endl;
+    }
+
+    return 0;
+}
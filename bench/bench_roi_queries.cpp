@@ -0,0 +1,66 @@
+// Compares answering a click with a full-frame analyze against the window-growing
+// ObjectDetection::analyzeAround, for images of growing size with objects of one size.
+// Every click must give the same contour and area on both paths.
+//
+// Build: cmake -S .. -B build && cmake --build build --target bench_roi_queries
+// Output: one CSV line per image size (width,height,clicks,full_ms,roi_ms,speedup)
+
+#include <opencv2/opencv.hpp>
+#include <iostream>
+#include <chrono>
+#include <cstdlib>
+#include "../main/ObjectDetection.hpp"
+#include "SyntheticImage.hpp"
+using namespace cv;
+
+int main(int argc, char** argv) {
+    int spacing = argc > 1 ? std::atoi(argv[1]) : 120;
+    int clicks = argc > 2 ? std::atoi(argv[2]) : 20;
+
+    const cv::Size sizes[] = { cv::Size(640, 480), cv::Size(1920, 1080), cv::Size(4000, 3000), cv::Size(8000, 6000) };
+
+    std::cout << "width,height,clicks,full_ms,roi_ms,speedup" << std::endl;
+
+    for (const cv::Size& size : sizes) {
+        cv::Mat image = createSyntheticImage(size.width, size.height, spacing);
+
+        ObjectDetection detection;
+        FrameAnalysis full;
+        FrameAnalysis local;
+        double fullMs = 0;
+        double roiMs = 0;
+
+        // Click near disc centers so most queries hit an object
+        cv::RNG rng(42);
+        for (int i = 0; i < clicks; i++) {
+            int column = rng.uniform(0, size.width / spacing);
+            int row = rng.uniform(0, size.height / spacing);
+            cv::Point point(spacing / 2 + column * spacing + rng.uniform(-5, 6), spacing / 2 + row * spacing + rng.uniform(-5, 6));
+
+            auto start = std::chrono::high_resolution_clock::now();
+            detection.analyze(image, full);
+            int fullIndex = full.findObjectAt(point);
+            auto middle = std::chrono::high_resolution_clock::now();
+            detection.analyzeAround(image, point, local);
+            int localIndex = local.findObjectAt(point);
+            auto end = std::chrono::high_resolution_clock::now();
+
+            bool same = (fullIndex < 0) == (localIndex < 0);
+            if (same && fullIndex > -1) {
+                same = full.getContour(fullIndex) == local.getContour(localIndex) && full.getArea(fullIndex) == local.getArea(localIndex);
+            }
+            if (!same) {
+                std::cerr << "Error: mismatch at point (" << point.x << ", " << point.y << ")" << std::endl;
+                return 1;
+            }
+
+            fullMs += std::chrono::duration<double, std::milli>(middle - start).count();
+            roiMs += std::chrono::duration<double, std::milli>(end - middle).count();
+        }
+
+        std::cout << size.width << "," << size.height << "," << clicks << "," << fullMs / clicks << ","
+            << roiMs / clicks << "," << fullMs / roiMs << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,65 @@
+// Runs both segmentation backends on the same synthetic images (several sizes and object
+// densities) and reports their time, object counts and how many Canny objects the
+// threshold-components backend also found (its centroid falls inside the other's bounding box).
+//
+// Build: cmake -S .. -B build && cmake --build build --target bench_segmentation
+// Output: one CSV line per image (megapixels,spacing,canny_ms,canny_objects,components_ms,components_objects,matched)
+
+#include <opencv2/opencv.hpp>
+#include <iostream>
+#include <chrono>
+#include <cstdlib>
+#include "../main/ObjectDetection.hpp"
+#include "SyntheticImage.hpp"
+using namespace cv;
+
+int main(int argc, char** argv) {
+    int repetitions = argc > 1 ? std::atoi(argv[1]) : 5;
+
+    const cv::Size sizes[] = { cv::Size(640, 480), cv::Size(1920, 1080), cv::Size(4000, 3000) };
+    const int spacings[] = { 60, 120, 240 };
+
+    std::cout << "megapixels,spacing,canny_ms,canny_objects,components_ms,components_objects,matched" << std::endl;
+
+    for (const cv::Size& size : sizes) {
+        for (int spacing : spacings) {
+            cv::Mat image = createSyntheticImage(size.width, size.height, spacing);
+
+            ObjectDetection detection;
+            FrameAnalysis canny, components;
+
+            // First run of each warms up the buffers
+            detection.analyze(image, canny, SegmentationMethod::CannyContours);
+            detection.analyze(image, components, SegmentationMethod::ThresholdComponents);
+
+            auto start = std::chrono::high_resolution_clock::now();
+            for (int i = 0; i < repetitions; i++) {
+                detection.analyze(image, canny, SegmentationMethod::CannyContours);
+            }
+            auto middle = std::chrono::high_resolution_clock::now();
+            for (int i = 0; i < repetitions; i++) {
+                detection.analyze(image, components, SegmentationMethod::ThresholdComponents);
+            }
+            auto end = std::chrono::high_resolution_clock::now();
+
+            int matched = 0;
+            for (int i = 0; i < canny.getObjectCount(); i++) {
+                cv::Point centroid(canny.getCentroid(i));
+                for (int j = 0; j < components.getObjectCount(); j++) {
+                    if (components.getBoundingBox(j).contains(centroid)) {
+                        matched++;
+                        break;
+                    }
+                }
+            }
+
+            double cannyMs = std::chrono::duration<double, std::milli>(middle - start).count() / repetitions;
+            double componentsMs = std::chrono::duration<double, std::milli>(end - middle).count() / repetitions;
+
+            std::cout << size.area() / 1e6 << "," << spacing << "," << cannyMs << "," << canny.getObjectCount() << ","
+                << componentsMs << "," << components.getObjectCount() << "," << matched << std::endl;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,67 @@
+// Selects every object of a synthetic image one click at a time and reports how the cost of a
+// click, the total area query and undo change as the selection grows. Also checks the running
+// totals against recomputing them from the selected contours.
+//
+// Build: cmake -S .. -B build && cmake --build build --target bench_selection_set
+// Output: one CSV line per selection size (selected,click_us,area_us,undo_us)
+
+#include <opencv2/opencv.hpp>
+#include <iostream>
+#include <chrono>
+#include <cmath>
+#include "../main/ObjectDetection.hpp"
+#include "../main/SelectionSet.hpp"
+#include "SyntheticImage.hpp"
+using namespace cv;
+
+int main() {
+    cv::Mat image = createSyntheticImage(4000, 3000, 60);
+
+    ObjectDetection detection;
+    FrameAnalysis analysis = detection.analyze(image);
+    std::cerr << "Objects: " << analysis.getObjectCount() << std::endl;
+
+    SelectionSet selection;
+
+    std::cout << "selected,click_us,area_us,undo_us" << std::endl;
+
+    int nextReport = 1;
+    for (int i = 0; i < analysis.getObjectCount(); i++) {
+        cv::Point click(analysis.getCentroid(i));
+
+        // A click first checks the selection, then adds the object under it
+        auto start = std::chrono::high_resolution_clock::now();
+        if (selection.findAt(click) < 0) {
+            selection.add(analysis.getContour(i));
+        }
+        auto clicked = std::chrono::high_resolution_clock::now();
+        double area = selection.getTotalArea();
+        auto measured = std::chrono::high_resolution_clock::now();
+
+        if (static_cast<int>(selection.size()) != nextReport) {
+            continue;
+        }
+        nextReport *= 2;
+
+        // Undo and redo the newest selection to time undo
+        auto undoStart = std::chrono::high_resolution_clock::now();
+        selection.undo();
+        auto undoEnd = std::chrono::high_resolution_clock::now();
+        selection.add(analysis.getContour(i));
+
+        double expected = 0;
+        for (const auto& contour : selection.getContours()) {
+            expected += cv::contourArea(contour);
+        }
+        if (std::abs(expected - area) > 1e-6 * std::max(expected, 1.0)) {
+            std::cerr << "Error: running area " << area << " differs from " << expected << std::endl;
+            return 1;
+        }
+
+        std::cout << selection.size() << "," << std::chrono::duration<double, std::micro>(clicked - start).count() << ","
+            << std::chrono::duration<double, std::micro>(measured - clicked).count() << ","
+            << std::chrono::duration<double, std::micro>(undoEnd - undoStart).count() << std::endl;
+    }
+
+    return 0;
+}
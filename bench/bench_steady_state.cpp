@@ -0,0 +1,59 @@
+// Runs the detection queries on a stream of same-sized frames and checks that, after warm-up,
+// ObjectDetection's scratch buffers stop allocating.
+//
+// Build: cmake -S .. -B build && cmake --build build --target bench_steady_state
+// Output: frames,ms_per_frame,allocations_after_warmup
+
+#include <opencv2/opencv.hpp>
+#include <iostream>
+#include <chrono>
+#include "../main/ObjectDetection.hpp"
+#include "SyntheticImage.hpp"
+using namespace cv;
+
+int main() {
+    const int warmupFrames = 3;
+    const int frames = 100;
+
+    // Two frames of the same size with a different number of objects
+    cv::Mat frameA = createSyntheticImage(1920, 1080, 120);
+    cv::Mat frameB = createSyntheticImage(1920, 1080, 90);
+    cv::Mat output = frameA.clone();
+
+    ObjectDetection detection;
+    FrameAnalysis analysis;
+
+    auto runFrame = [&](int i) {
+        const cv::Mat& input = (i % 2 == 0) ? frameA : frameB;
+        input.copyTo(output);
+
+        detection.analyze(input, analysis);
+        detection.identifyCenterObject(output, analysis);
+        detection.centerObjectInfo(output);
+        detection.findObjectArea(analysis, output.cols / 2, output.rows / 2);
+    };
+
+    for (int i = 0; i < warmupFrames; i++) {
+        runFrame(i);
+    }
+    size_t allocationsAfterWarmup = detection.getAllocationCount();
+
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < frames; i++) {
+        runFrame(i);
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+
+    size_t allocations = detection.getAllocationCount() - allocationsAfterWarmup;
+    double msPerFrame = std::chrono::duration<double, std::milli>(end - start).count() / frames;
+
+    std::cout << "frames,ms_per_frame,allocations_after_warmup" << std::endl;
+    std::cout << frames << "," << msPerFrame << "," << allocations << std::endl;
+
+    if (allocations != 0) {
+        std::cerr << "Error: scratch buffers allocated " << allocations << " times after warm-up" << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,80 @@
+// Compares TiledDetection with a full-frame ObjectDetection::analyze on synthetic images.
+// Discs are placed so many of them cross tile borders; both paths must find the same objects,
+// total area and area-weighted centroid.
+//
+// Usage: bench_tiled [tile_size] [spacing]
+//   tile_size  side of the tiles in pixels (default 1024)
+//   spacing    distance between synthetic objects in pixels (default 120)
+//
+// Build: cmake -S .. -B build && cmake --build build --target bench_tiled
+// Output: one CSV line per image size
+//   (width,height,tile_size,tiles,objects,stitched,largest_region,full_ms,tiled_ms,full_area,tiled_area)
+//   largest_region is the longest side of any tile or stitching region traced, without its halo
+
+#include <opencv2/opencv.hpp>
+#include <algorithm>
+#include <iostream>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include "../main/ObjectDetection.hpp"
+#include "../main/TiledDetection.hpp"
+#include "SyntheticImage.hpp"
+using namespace cv;
+
+int main(int argc, char** argv) {
+    int tileSize = argc > 1 ? std::atoi(argv[1]) : 1024;
+    int spacing = argc > 2 ? std::atoi(argv[2]) : 120;
+
+    if (tileSize < 64 || spacing < 10) {
+        std::cerr << "Usage: bench_tiled [tile_size >= 64] [spacing >= 10]" << std::endl;
+        return 1;
+    }
+
+    const cv::Size sizes[] = { cv::Size(1920, 1080), cv::Size(4000, 3000), cv::Size(8000, 6000) };
+
+    std::cout << "width,height,tile_size,tiles,objects,stitched,largest_region,full_ms,tiled_ms,full_area,tiled_area" << std::endl;
+
+    for (const cv::Size& size : sizes) {
+        cv::Mat image = createSyntheticImage(size.width, size.height, spacing);
+
+        ObjectDetection detection;
+        auto start = std::chrono::high_resolution_clock::now();
+        FrameAnalysis full = detection.analyze(image);
+        auto middle = std::chrono::high_resolution_clock::now();
+
+        TiledDetection tiled;
+        tiled.tileSize = tileSize;
+        MatTileSource source(image);
+        FrameAnalysis stitched = tiled.analyze(source);
+        auto end = std::chrono::high_resolution_clock::now();
+
+        double fullArea = 0;
+        double tiledArea = 0;
+        cv::Point2d fullCenter(0, 0);
+        cv::Point2d tiledCenter(0, 0);
+        for (int i = 0; i < full.getObjectCount(); i++) {
+            fullArea += full.getArea(i);
+            fullCenter += cv::Point2d(full.getCentroid(i)) * full.getArea(i);
+        }
+        for (int i = 0; i < stitched.getObjectCount(); i++) {
+            tiledArea += stitched.getArea(i);
+            tiledCenter += cv::Point2d(stitched.getCentroid(i)) * stitched.getArea(i);
+        }
+
+        if (full.getObjectCount() != stitched.getObjectCount() || std::abs(fullArea - tiledArea) > 1e-6 * fullArea
+            || cv::norm(fullCenter - tiledCenter) > 1e-6 * cv::norm(fullCenter)) {
+            std::cerr << "Error: tiled result differs at " << size.width << "x" << size.height << std::endl;
+            return 1;
+        }
+
+        std::cout << size.width << "," << size.height << "," << tileSize << "," << tiled.getTileCount() << ","
+            << stitched.getObjectCount() << "," << tiled.getStitchedCount() << ","
+            << std::max(tiled.getLargestRegion().width, tiled.getLargestRegion().height) << ","
+            << std::chrono::duration<double, std::milli>(middle - start).count() << ","
+            << std::chrono::duration<double, std::milli>(end - middle).count() << ","
+            << fullArea << "," << tiledArea << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,50 @@
+// Measures what tracing costs: an empty traced scope in a tight loop, and the detection pipeline on a
+// synthetic frame. Run it from builds with and without -DOBJECTDETECTION_TRACING=ON and compare
+// ms_per_frame. Also writes bench_tracing.json (open in chrome://tracing or Perfetto) and bench_tracing.prom.
+//
+// Build: cmake -S .. -B build -DOBJECTDETECTION_TRACING=ON && cmake --build build --target bench_tracing
+// Output: tracing_enabled,ns_per_scope,frames,ms_per_frame
+
+#include <opencv2/opencv.hpp>
+#include <iostream>
+#include <chrono>
+#include "../main/ObjectDetection.hpp"
+#include "../main/Tracing.hpp"
+#include "SyntheticImage.hpp"
+using namespace cv;
+
+int main() {
+    const int scopes = 1000000;
+    const int frames = 50;
+
+    auto scopeStart = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < scopes; i++) {
+        TRACE_SCOPE("bench_scope");
+    }
+    auto scopeEnd = std::chrono::high_resolution_clock::now();
+    double nsPerScope = std::chrono::duration<double, std::nano>(scopeEnd - scopeStart).count() / scopes;
+
+    // Keep only the pipeline's own events in the exported files
+    Tracing::reset();
+
+    cv::Mat image = createSyntheticImage(1920, 1080, 120);
+    ObjectDetection detection;
+    FrameAnalysis analysis;
+    detection.analyze(image, analysis);
+
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < frames; i++) {
+        detection.analyze(image, analysis);
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    double msPerFrame = std::chrono::duration<double, std::milli>(end - start).count() / frames;
+
+    std::cout << "tracing_enabled,ns_per_scope,frames,ms_per_frame" << std::endl;
+    std::cout << (Tracing::isEnabled() ? 1 : 0) << "," << nsPerScope << "," << frames << "," << msPerFrame << std::endl;
+
+    if (!Tracing::writeChromeTrace("bench_tracing.json") || !Tracing::writePrometheus("bench_tracing.prom")) {
+        return 1;
+    }
+
+    return 0;
+}
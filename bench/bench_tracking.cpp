@@ -0,0 +1,80 @@
+// Simulates a conveyor camera: a synthetic scene moves a few pixels per frame, and every frame is
+// answered once by a full-frame center query and once by ObjectDetection::trackCenterObject.
+// The tracked contour must be the one the full-frame analysis finds at the tracked centroid,
+// and the track id must not change while the object stays in view.
+//
+// Usage: bench_tracking [frames] [pixels_per_frame]
+//   frames            frames in the sequence (default 100)
+//   pixels_per_frame  motion of the scene between two frames (default 3)
+//
+// Build: cmake -S .. -B build && cmake --build build --target bench_tracking
+// Output: one CSV line per image size
+//   (width,height,frames,full_ms_per_frame,track_ms_per_frame,speedup,redetections,id_changes)
+
+#include <opencv2/opencv.hpp>
+#include <iostream>
+#include <chrono>
+#include <cstdlib>
+#include "../main/ObjectDetection.hpp"
+#include "SyntheticImage.hpp"
+using namespace cv;
+
+int main(int argc, char** argv) {
+    int frames = argc > 1 ? std::atoi(argv[1]) : 100;
+    int speed = argc > 2 ? std::atoi(argv[2]) : 3;
+
+    if (frames < 2 || speed < 0) {
+        std::cerr << "Usage: bench_tracking [frames >= 2] [pixels_per_frame >= 0]" << std::endl;
+        return 1;
+    }
+
+    const cv::Size sizes[] = { cv::Size(1920, 1080), cv::Size(4000, 3000) };
+
+    std::cout << "width,height,frames,full_ms_per_frame,track_ms_per_frame,speedup,redetections,id_changes" << std::endl;
+
+    for (const cv::Size& size : sizes) {
+        // Frame i is a window sliding left over a wider scene, so the content moves right
+        cv::Mat scene = createSyntheticImage(size.width + frames * speed, size.height, 120);
+
+        ObjectDetection full;
+        ObjectDetection tracker;
+        double fullMs = 0;
+        double trackMs = 0;
+        int redetections = 0;
+        int idChanges = 0;
+        int lastId = -1;
+
+        for (int i = 0; i < frames; i++) {
+            cv::Mat frame = scene(cv::Rect((frames - i) * speed, 0, size.width, size.height));
+
+            auto start = std::chrono::high_resolution_clock::now();
+            FrameAnalysis analysis = full.analyze(frame);
+            int center = analysis.findCenterObject();
+            auto middle = std::chrono::high_resolution_clock::now();
+            TrackedObject tracked = tracker.trackCenterObject(frame);
+            auto end = std::chrono::high_resolution_clock::now();
+
+            fullMs += std::chrono::duration<double, std::milli>(middle - start).count();
+            trackMs += std::chrono::duration<double, std::milli>(end - middle).count();
+            redetections += tracked.redetected ? 1 : 0;
+            idChanges += (lastId > -1 && tracked.trackId != lastId) ? 1 : 0;
+            lastId = tracked.trackId;
+
+            if (center < 0 || tracked.trackId < 0) {
+                std::cerr << "Error: no object in frame " << i << std::endl;
+                return 1;
+            }
+
+            int index = analysis.findObjectAt(cv::Point(cvRound(tracked.record.centroidX), cvRound(tracked.record.centroidY)));
+            if (index < 0 || analysis.getContour(index) != tracked.contour) {
+                std::cerr << "Error: tracked contour differs from the full frame in frame " << i << std::endl;
+                return 1;
+            }
+        }
+
+        std::cout << size.width << "," << size.height << "," << frames << "," << fullMs / frames << "," << trackMs / frames << ","
+            << fullMs / trackMs << "," << redetections << "," << idChanges << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,92 @@
+#include <opencv2/opencv.hpp>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include "../main/ObjectDetection.hpp"
+#include "../main/SharedFrameRing.hpp"
+using namespace cv;
+
+// Shared-memory ingestion: maps the frame ring a capture process (or producer) created and finds the
+// center object of every frame directly in the ring's slots, so detection is the only per-frame cost.
+// Each slot is released as soon as its analysis is done; the analysis keeps no pointer into it.
+//
+// Usage: ingest <ring name>
+// Output: frames,seconds,frames_per_second,detect_ms_per_frame,p50_latency_ms,p99_latency_ms
+//
+// Latency is from the producer publishing a frame to its detection finishing.
+
+static int64_t steadyNanoseconds() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::cerr << "Usage: ingest <ring name>" << std::endl;
+        return 1;
+    }
+
+    // The producer may still be setting the ring up
+    SharedFrameRing ring;
+    for (int attempt = 0; attempt < 1000 && !ring.open(argv[1]); attempt++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    if (!ring.isOpen()) {
+        std::cerr << "Error: Could not open the shared frame ring." << std::endl;
+        return 1;
+    }
+
+    ObjectDetection detection;
+    FrameAnalysis analysis;
+    std::vector<double> latencies;
+    double detectSeconds = 0;
+    size_t centerObjects = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    bool started = false;
+
+    while (!ring.isFinished()) {
+        cv::Mat frame;
+        int64_t published;
+        if (!ring.beginRead(frame, published)) {
+            std::this_thread::yield();
+            continue;
+        }
+
+        // Time from the first frame, not from waiting for the producer
+        if (!started) {
+            start = std::chrono::steady_clock::now();
+            started = true;
+        }
+
+        auto detectStart = std::chrono::steady_clock::now();
+        detection.analyze(frame, analysis);
+        if (analysis.findCenterObject() > -1) {
+            centerObjects++;
+        }
+        detectSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - detectStart).count();
+
+        ring.endRead();
+        latencies.push_back((steadyNanoseconds() - published) / 1e6);
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    size_t frames = latencies.size();
+
+    std::sort(latencies.begin(), latencies.end());
+    auto percentile = [&](double fraction) {
+        return frames > 0 ? latencies[std::min(frames - 1, static_cast<size_t>(fraction * frames))] : 0.0;
+    };
+
+    std::cout << "frames,seconds,frames_per_second,detect_ms_per_frame,p50_latency_ms,p99_latency_ms" << std::endl;
+    std::cout << frames << "," << seconds << "," << (seconds > 0 ? frames / seconds : 0) << ","
+        << (frames > 0 ? detectSeconds * 1000 / frames : 0) << "," << percentile(0.50) << "," << percentile(0.99) << std::endl;
+
+    if (centerObjects < frames) {
+        std::cerr << frames - centerObjects << " frames had no center object" << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,116 @@
+#include <opencv2/opencv.hpp>
+#include <iostream>
+#include <string>
+#include <cstring>
+#include <cstdlib>
+#include <cstdio>
+#include <chrono>
+#include <thread>
+#include "../main/SharedFrameRing.hpp"
+#include "../bench/SyntheticImage.hpp"
+using namespace cv;
+
+// Test producer for the shared-memory frame ring: stands in for a capture process by writing
+// synthetic BGR frames straight into the ring's slots, as a camera or decoder would, then waits
+// until the consumer (ingest) has read them all. Start it first, then ingest with the same name.
+//
+// Usage: producer <ring name> [--size <width>x<height>] [--frames <n>] [--slots <n>] [--fps <n>] [--timeout <seconds>]
+// Output: frames,seconds,frames_per_second,full_waits
+//
+// --fps 0 (the default) publishes as fast as the consumer releases slots.
+// --timeout is how long to wait for a consumer to attach (default 10). The producer exits with an
+// error when no consumer attached in that time or the consumer went away before reading every frame.
+
+static int64_t steadyNanoseconds() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::cerr << "Usage: producer <ring name> [--size <width>x<height>] [--frames <n>] [--slots <n>] [--fps <n>] [--timeout <seconds>]" << std::endl;
+        return 1;
+    }
+
+    cv::Size frameSize(1920, 1080);
+    int frames = 1000;
+    int slotCount = 8;
+    double fps = 0;
+    double timeout = 10;
+    for (int i = 2; i + 1 < argc; i += 2) {
+        if (std::strcmp(argv[i], "--size") == 0) {
+            std::sscanf(argv[i + 1], "%dx%d", &frameSize.width, &frameSize.height);
+        }
+        else if (std::strcmp(argv[i], "--frames") == 0) {
+            frames = std::max(1, std::atoi(argv[i + 1]));
+        }
+        else if (std::strcmp(argv[i], "--slots") == 0) {
+            slotCount = std::max(1, std::atoi(argv[i + 1]));
+        }
+        else if (std::strcmp(argv[i], "--fps") == 0) {
+            fps = std::max(0.0, std::atof(argv[i + 1]));
+        }
+        else if (std::strcmp(argv[i], "--timeout") == 0) {
+            timeout = std::max(0.0, std::atof(argv[i + 1]));
+        }
+    }
+
+    SharedFrameRing ring;
+    if (!ring.create(argv[1], frameSize, CV_8UC3, slotCount)) {
+        return 1;
+    }
+
+    // Two scenes with a different number of objects, alternated so every frame has work to do
+    cv::Mat scenes[] = { createSyntheticImage(frameSize.width, frameSize.height, 120), createSyntheticImage(frameSize.width, frameSize.height, 90) };
+
+    // A consumer that went away will not read the ring again; one that has not attached yet gets
+    // timeout seconds from the start
+    bool attached = false;
+    auto start = std::chrono::steady_clock::now();
+    auto consumerLost = [&]() {
+        if (ring.isConsumerAttached()) {
+            attached = true;
+            return false;
+        }
+        return attached || std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() > timeout;
+    };
+
+    size_t fullWaits = 0;
+
+    for (int i = 0; i < frames; i++) {
+        if (fps > 0) {
+            std::this_thread::sleep_until(start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(i / fps)));
+        }
+
+        cv::Mat slot;
+        while (!ring.beginWrite(slot)) {
+            if (consumerLost()) {
+                std::cerr << "Error: No consumer is reading the shared frame ring, stopped after " << i << " frames." << std::endl;
+                return 1;
+            }
+            fullWaits++;
+            std::this_thread::yield();
+        }
+
+        // The capture's own write of the frame; the consumer reads these pixels in place
+        scenes[i % 2].copyTo(slot);
+        ring.endWrite(steadyNanoseconds());
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    ring.finish();
+
+    // Keep the name until the consumer has drained the ring, in case it has not opened it yet
+    while (!ring.isFinished()) {
+        // The consumer detaches right after reading the last frame, so check that it did not
+        if (consumerLost() && !ring.isFinished()) {
+            std::cerr << "Error: The consumer left before reading every frame." << std::endl;
+            return 1;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    std::cout << "frames,seconds,frames_per_second,full_waits" << std::endl;
+    std::cout << frames << "," << seconds << "," << frames / seconds << "," << fullWaits << std::endl;
+
+    return 0;
+}
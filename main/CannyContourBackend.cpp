@@ -0,0 +1,30 @@
+#include "CannyContourBackend.hpp"
+#include "Tracing.hpp"
+
+const char* CannyContourBackend::getName() const {
+    return "canny-contours";
+}
+
+size_t CannyContourBackend::getAllocationCount() const {
+    return arena.getAllocationCount() + preprocessor.getAllocationCount();
+}
+
+void CannyContourBackend::segment(const cv::Mat& image, double minArea, FrameAnalysis& analysis) {
+    TRACE_SCOPE("segment");
+    // Grayscale, Canny and dilation run fused in row bands, see EdgePreprocessor
+    preprocessor.process(image, dilatedEdges, 2 + ((image.rows + image.cols) / 1500));
+
+    // Find contours in the mask
+    {
+        TRACE_SCOPE("find_contours");
+        cv::findContours(dilatedEdges, rawContours, cv::RETR_EXTERNAL, cv::CHAIN_APPROX_SIMPLE);
+    }
+
+    // Keep the contours above the minimum area together with their statistics
+    analysis.assign(image.size(), rawContours, minArea, arena);
+
+    // Counted here rather than in assign, which the window, pyramid and tile passes call several times per query.
+    // assign swaps the accepted contours out but keeps the size of rawContours.
+    TRACE_COUNT("contours_found", rawContours.size());
+    TRACE_COUNT("contours_filtered", rawContours.size() - analysis.getObjectCount());
+}
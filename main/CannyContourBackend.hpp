@@ -0,0 +1,25 @@
+#ifndef CANNYCONTOURBACKEND_HPP
+#define CANNYCONTOURBACKEND_HPP
+
+#include <opencv2/opencv.hpp>
+#include <vector>
+#include "EdgePreprocessor.hpp"
+#include "SegmentationBackend.hpp"
+using namespace cv;
+
+// The original pipeline: gray, Canny and dilate (see EdgePreprocessor), then the external contours.
+// Areas are polygon areas of the contours and centroids come from their moments.
+class CannyContourBackend : public SegmentationBackend {
+public:
+    void segment(const cv::Mat& image, double minArea, FrameAnalysis& analysis) override;
+    const char* getName() const override;
+    size_t getAllocationCount() const override;
+
+private:
+    ScratchArena arena;
+    EdgePreprocessor preprocessor;
+    cv::Mat dilatedEdges;
+    std::vector<std::vector<cv::Point>> rawContours;
+};
+
+#endif // CANNYCONTOURBACKEND_HPP
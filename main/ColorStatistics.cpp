@@ -0,0 +1,97 @@
+#include "ColorStatistics.hpp"
+#include <cmath>
+
+// Value of the first bin at which the running count passes half of total, walking the bins from start
+template<size_t N>
+static int findMedianBin(const std::array<int, N>& histogram, int total, int start) {
+    int half = (total + 1) / 2;
+    int count = 0;
+
+    for (size_t i = 0; i < N; i++) {
+        int bin = static_cast<int>((start + i) % N);
+        count += histogram[bin];
+        if (count >= half) {
+            return bin;
+        }
+    }
+
+    return start;
+}
+
+// Unit vector of every 8-bit hue, two hue steps per degree
+struct HueVectors {
+    HueVectors() {
+        for (int hue = 0; hue < 180; hue++) {
+            cosines[hue] = std::cos(hue * CV_PI / 90);
+            sines[hue] = std::sin(hue * CV_PI / 90);
+        }
+    }
+
+    std::array<double, 180> cosines;
+    std::array<double, 180> sines;
+};
+
+cv::Rect ColorStatistics::getCenterRegion(cv::Size imageSize) {
+    int side = std::max(8, std::min(imageSize.width, imageSize.height) / 50);
+
+    cv::Rect region(imageSize.width / 2 - side / 2, imageSize.height / 2 - side / 2, side, side);
+    return region & cv::Rect(0, 0, imageSize.width, imageSize.height);
+}
+
+HSVStatistics ColorStatistics::compute(const cv::Mat& image, cv::Rect roi) {
+    HSVStatistics stats;
+    stats.mean = cv::Vec3b(0, 0, 0);
+    stats.median = cv::Vec3b(0, 0, 0);
+    stats.hueConcentration = 0;
+    stats.hueHistogram.fill(0);
+    saturationHistogram.fill(0);
+    valueHistogram.fill(0);
+
+    roi &= cv::Rect(0, 0, image.cols, image.rows);
+    stats.pixelCount = roi.area();
+    if (stats.pixelCount == 0 || image.type() != CV_8UC3) {
+        stats.pixelCount = 0;
+        return stats;
+    }
+
+    // Convert and count one row at a time so only the region is ever touched
+    rowBuffer.create(1, roi.width, CV_8UC3);
+    for (int y = roi.y; y < roi.y + roi.height; y++) {
+        cv::cvtColor(image.row(y).colRange(roi.x, roi.x + roi.width), rowBuffer, cv::COLOR_BGR2HSV);
+
+        const uchar* pixel = rowBuffer.ptr<uchar>(0);
+        for (int x = 0; x < roi.width; x++, pixel += 3) {
+            stats.hueHistogram[pixel[0]]++;
+            saturationHistogram[pixel[1]]++;
+            valueHistogram[pixel[2]]++;
+        }
+    }
+
+    // Hue is an angle, so average it as unit vectors instead of as numbers
+    static const HueVectors hueVectors;
+    double sumCos = 0, sumSin = 0;
+    for (int hue = 0; hue < 180; hue++) {
+        sumCos += stats.hueHistogram[hue] * hueVectors.cosines[hue];
+        sumSin += stats.hueHistogram[hue] * hueVectors.sines[hue];
+    }
+
+    int meanHue = cvRound(std::atan2(sumSin, sumCos) * 90 / CV_PI);
+    meanHue = (meanHue % 180 + 180) % 180;
+    stats.hueConcentration = std::sqrt(sumCos * sumCos + sumSin * sumSin) / stats.pixelCount;
+
+    double sumS = 0, sumV = 0;
+    for (int i = 0; i < 256; i++) {
+        sumS += static_cast<double>(i) * saturationHistogram[i];
+        sumV += static_cast<double>(i) * valueHistogram[i];
+    }
+
+    stats.mean = cv::Vec3b(static_cast<uchar>(meanHue), cv::saturate_cast<uchar>(sumS / stats.pixelCount), cv::saturate_cast<uchar>(sumV / stats.pixelCount));
+
+    // The circular median starts counting at the hue opposite the mean so the wrap-around at 0/180 falls outside the bulk
+    stats.median = cv::Vec3b(
+        static_cast<uchar>(findMedianBin(stats.hueHistogram, stats.pixelCount, (meanHue + 90) % 180)),
+        static_cast<uchar>(findMedianBin(saturationHistogram, stats.pixelCount, 0)),
+        static_cast<uchar>(findMedianBin(valueHistogram, stats.pixelCount, 0)));
+
+    return stats;
+}
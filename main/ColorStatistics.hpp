@@ -0,0 +1,41 @@
+#ifndef COLORSTATISTICS_HPP
+#define COLORSTATISTICS_HPP
+
+#include <opencv2/opencv.hpp>
+#include <array>
+#include <vector>
+using namespace cv;
+
+// HSV statistics of an image region, in OpenCV's 8-bit ranges (H 0-179, S and V 0-255)
+struct HSVStatistics {
+    // Hue is the circular mean, so red pixels at 2 and 178 average to 0 instead of 90
+    cv::Vec3b mean;
+
+    // Hue median is taken around the circular mean, starting from the opposite hue
+    cv::Vec3b median;
+
+    // Length of the mean hue vector: 1 when all pixels share one hue, near 0 when hues are spread out
+    double hueConcentration;
+
+    int pixelCount;
+    std::array<int, 180> hueHistogram;
+};
+
+// Computes HSV statistics over a region of a BGR image without converting the rest of the image.
+// Each row of the region is converted with OpenCV's vectorized cvtColor into a small buffer and
+// counted into per-channel histograms while still in cache; means and medians come from the histograms.
+class ColorStatistics {
+public:
+    // Statistics of roi, clipped to the image; pixelCount is 0 when nothing is left
+    HSVStatistics compute(const cv::Mat& image, cv::Rect roi);
+
+    // Square around the image center with a side of about 2% of the shorter image side, at least 8 pixels
+    static cv::Rect getCenterRegion(cv::Size imageSize);
+
+private:
+    cv::Mat rowBuffer;
+    std::array<int, 256> saturationHistogram;
+    std::array<int, 256> valueHistogram;
+};
+
+#endif // COLORSTATISTICS_HPP
@@ -0,0 +1,122 @@
+#include "ContourStats.hpp"
+#include <algorithm>
+#include <cfloat>
+#include <climits>
+#include <cmath>
+#include <limits>
+
+size_t ContourStats::size() const {
+    return areas.size();
+}
+
+void ContourStats::resize(size_t count, ScratchArena& arena) {
+    arena.resize(areas, count);
+    arena.resize(m00, count);
+    arena.resize(m10, count);
+    arena.resize(m01, count);
+    arena.resize(centroidX, count);
+    arena.resize(centroidY, count);
+    arena.resize(boxX, count);
+    arena.resize(boxY, count);
+    arena.resize(boxWidth, count);
+    arena.resize(boxHeight, count);
+    arena.resize(perimeters, count);
+}
+
+void ContourStats::moveRow(size_t from, size_t to) {
+    areas[to] = areas[from];
+    m00[to] = m00[from];
+    m10[to] = m10[from];
+    m01[to] = m01[from];
+    centroidX[to] = centroidX[from];
+    centroidY[to] = centroidY[from];
+    boxX[to] = boxX[from];
+    boxY[to] = boxY[from];
+    boxWidth[to] = boxWidth[from];
+    boxHeight[to] = boxHeight[from];
+    perimeters[to] = perimeters[from];
+}
+
+void ContourStats::compute(const std::vector<std::vector<cv::Point>>& contours, ScratchArena& arena) {
+    resize(contours.size(), arena);
+
+    cv::parallel_for_(cv::Range(0, static_cast<int>(contours.size())), [&](const cv::Range& range) {
+        for (int i = range.start; i < range.end; i++) {
+            const std::vector<cv::Point>& contour = contours[i];
+
+            // Green's theorem over the closed polygon, with the same sums as cv::contourArea and cv::moments.
+            // Every term is an integer, so the sums are exact in any order.
+            double a00 = 0;
+            double a10 = 0;
+            double a01 = 0;
+            double perimeter = 0;
+            int minX = INT_MAX;
+            int minY = INT_MAX;
+            int maxX = INT_MIN;
+            int maxY = INT_MIN;
+
+            if (!contour.empty()) {
+                cv::Point previous = contour.back();
+                for (const cv::Point& point : contour) {
+                    double cross = static_cast<double>(previous.x) * point.y - static_cast<double>(point.x) * previous.y;
+                    a00 += cross;
+                    a10 += cross * (previous.x + point.x);
+                    a01 += cross * (previous.y + point.y);
+
+                    double dx = point.x - previous.x;
+                    double dy = point.y - previous.y;
+                    perimeter += std::sqrt(dx * dx + dy * dy);
+
+                    minX = std::min(minX, point.x);
+                    minY = std::min(minY, point.y);
+                    maxX = std::max(maxX, point.x);
+                    maxY = std::max(maxY, point.y);
+                    previous = point;
+                }
+            }
+            else {
+                minX = minY = 0;
+                maxX = maxY = -1;
+            }
+
+            // cv::moments reports positive moments for either orientation and zero for degenerate contours
+            double half = 0;
+            double sixth = 0;
+            if (std::fabs(a00) > FLT_EPSILON) {
+                half = a00 > 0 ? 0.5 : -0.5;
+                sixth = a00 > 0 ? 1.0 / 6 : -1.0 / 6;
+            }
+
+            areas[i] = std::fabs(a00 * 0.5);
+            m00[i] = a00 * half;
+            m10[i] = a10 * sixth;
+            m01[i] = a01 * sixth;
+            centroidX[i] = static_cast<float>(m10[i] / m00[i]);
+            centroidY[i] = static_cast<float>(m01[i] / m00[i]);
+            boxX[i] = minX;
+            boxY[i] = minY;
+            boxWidth[i] = maxX - minX + 1;
+            boxHeight[i] = maxY - minY + 1;
+            perimeters[i] = perimeter;
+        }
+    });
+}
+
+int ContourStats::findNearestCentroid(cv::Point2f target) const {
+    int nearest = -1;
+    float minDist = std::numeric_limits<float>::max();
+
+    // Same distance as cv::norm on the float difference, so ties resolve as before
+    for (size_t i = 0; i < centroidX.size(); i++) {
+        float dx = target.x - centroidX[i];
+        float dy = target.y - centroidY[i];
+        float dist = static_cast<float>(std::sqrt(static_cast<double>(dx) * dx + static_cast<double>(dy) * dy));
+
+        if (dist < minDist) {
+            minDist = dist;
+            nearest = static_cast<int>(i);
+        }
+    }
+
+    return nearest;
+}
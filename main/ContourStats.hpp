@@ -0,0 +1,39 @@
+#ifndef CONTOURSTATS_HPP
+#define CONTOURSTATS_HPP
+
+#include <opencv2/opencv.hpp>
+#include <vector>
+#include "ScratchArena.hpp"
+using namespace cv;
+
+// Per-contour statistics in structure-of-arrays layout, one column per value, so the selection
+// loops over thousands of contours read only the columns they need and can vectorize.
+// compute fills every column in a single pass over each contour's points, with contours spread
+// over threads. Areas equal cv::contourArea, and m00, m10 and m01 equal those of cv::moments.
+struct ContourStats {
+    // Fills the table for contours, reusing the columns' memory
+    void compute(const std::vector<std::vector<cv::Point>>& contours, ScratchArena& arena);
+
+    // Copies row from into row to, for compacting the table after filtering
+    void moveRow(size_t from, size_t to);
+    void resize(size_t count, ScratchArena& arena);
+
+    size_t size() const;
+
+    // Row whose centroid is closest to target, -1 for an empty table
+    int findNearestCentroid(cv::Point2f target) const;
+
+    std::vector<double> areas;
+    std::vector<double> m00;
+    std::vector<double> m10;
+    std::vector<double> m01;
+    std::vector<float> centroidX;
+    std::vector<float> centroidY;
+    std::vector<int> boxX;
+    std::vector<int> boxY;
+    std::vector<int> boxWidth;
+    std::vector<int> boxHeight;
+    std::vector<double> perimeters;
+};
+
+#endif // CONTOURSTATS_HPP
@@ -0,0 +1,81 @@
+#include "EdgePreprocessor.hpp"
+#include "MaxFilter.hpp"
+#include "Tracing.hpp"
+
+int EdgePreprocessor::getBandRows(const cv::Mat& image) {
+    // Aim for about 256 KB of input and gray rows per band, roughly the L2 cache of one core
+    const size_t bandBytes = 256 * 1024;
+    size_t rowBytes = static_cast<size_t>(image.cols) * (image.channels() + 1);
+    int rows = static_cast<int>(bandBytes / std::max<size_t>(rowBytes, 1));
+
+    return std::max(rows, 8);
+}
+
+int EdgePreprocessor::getBorderMargin(int dilateIterations) const {
+    // Blur radius, plus one pixel each for the Sobel kernel and non-maximum suppression in Canny
+    int blurRadius = std::max(blurSize.width, blurSize.height) / 2;
+    if (blurRadius == 0 && blurSigma > 0) {
+        blurRadius = cvCeil(blurSigma * 4);
+    }
+
+    return blurRadius + 2 + dilateIterations;
+}
+
+size_t EdgePreprocessor::getAllocationCount() const {
+    return arena.getAllocationCount();
+}
+
+void EdgePreprocessor::process(const cv::Mat& image, cv::Mat& output, int dilateIterations) {
+    int bandRows = getBandRows(image);
+    int bandCount = (image.rows + bandRows - 1) / bandRows;
+
+    // Convert to grayscale band by band while the input rows are still in cache.
+    // Images decoded as grayscale are copied, since the blur below works in place.
+    arena.prepare(gray, image.size(), CV_8UC1);
+    cv::parallel_for_(cv::Range(0, bandCount), [&](const cv::Range& range) {
+        TRACE_SCOPE("gray");
+        for (int band = range.start; band < range.end; band++) {
+            int top = band * bandRows;
+            int bottom = std::min(top + bandRows, image.rows);
+
+            cv::Mat grayBand = gray.rowRange(top, bottom);
+            if (image.channels() == 1) {
+                image.rowRange(top, bottom).copyTo(grayBand);
+            }
+            else {
+                cv::cvtColor(image.rowRange(top, bottom), grayBand, cv::COLOR_BGR2GRAY);
+            }
+        }
+    });
+
+    // A 1x1 Gaussian kernel is the identity, so only real blurs are run
+    if (blurSize.width > 1 || blurSize.height > 1) {
+        TRACE_SCOPE("blur");
+        cv::GaussianBlur(gray, gray, blurSize, blurSigma, blurSigma);
+    }
+
+    // Hysteresis can follow an edge across the whole frame, so Canny has to see all of it
+    arena.prepare(edges, image.size(), CV_8UC1);
+    {
+        TRACE_SCOPE("canny");
+        cv::Canny(gray, edges, cannyThreshold1, cannyThreshold2);
+    }
+
+    // Dilate band by band straight into the output with the square max filter, equal to the iterated
+    // 3x3 dilate. Each band also reads dilateIterations rows of the edge map above and below it, so bands
+    // are kept at least two windows tall to bound that overlap.
+    int dilateBandRows = std::max(bandRows, 2 * (2 * dilateIterations + 1));
+    int dilateBandCount = (image.rows + dilateBandRows - 1) / dilateBandRows;
+
+    arena.prepare(output, image.size(), CV_8UC1);
+    cv::parallel_for_(cv::Range(0, dilateBandCount), [&](const cv::Range& range) {
+        TRACE_SCOPE("dilate");
+        for (int band = range.start; band < range.end; band++) {
+            int top = band * dilateBandRows;
+            int bottom = std::min(top + dilateBandRows, image.rows);
+
+            cv::Mat outputBand = output.rowRange(top, bottom);
+            dilateSquareRows(edges, top, bottom, dilateIterations, outputBand);
+        }
+    });
+}
@@ -0,0 +1,40 @@
+#ifndef EDGEPREPROCESSOR_HPP
+#define EDGEPREPROCESSOR_HPP
+
+#include <opencv2/opencv.hpp>
+#include "ScratchArena.hpp"
+using namespace cv;
+
+// Grayscale -> blur -> Canny -> dilate, producing the same edge map as running the
+// four OpenCV calls on full frames one after another.
+// Gray conversion and dilation run on cache-sized row bands in parallel, an identity
+// blur is skipped, and the gray and edge buffers are kept between calls. Dilation uses the
+// van Herk/Gil-Werman max filter (see MaxFilter), whose comparisons per pixel do not grow with
+// the iterations, unlike the (2N + 1) rect pass cv::dilate makes of N iterations.
+class EdgePreprocessor {
+public:
+    // Writes the dilated edge map of image (BGR or grayscale) into output
+    void process(const cv::Mat& image, cv::Mat& output, int dilateIterations);
+
+    // Number of rows per band so a band of the input and its gray copy stay in cache
+    static int getBandRows(const cv::Mat& image);
+
+    // Distance from the input border within which the edge map can differ from a run on a larger
+    // image, so callers working on a view can pad it by this much and ignore the padding afterwards
+    int getBorderMargin(int dilateIterations) const;
+
+    // Buffers (re)allocated by process, including output, see ScratchArena
+    size_t getAllocationCount() const;
+
+    cv::Size blurSize = cv::Size(1, 1);
+    double blurSigma = 0;
+    double cannyThreshold1 = 50;
+    double cannyThreshold2 = 135;
+
+private:
+    ScratchArena arena;
+    cv::Mat gray;
+    cv::Mat edges;
+};
+
+#endif // EDGEPREPROCESSOR_HPP
\ No newline at end of file
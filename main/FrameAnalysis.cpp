@@ -0,0 +1,225 @@
+#include "FrameAnalysis.hpp"
+#include "Tracing.hpp"
+
+FrameAnalysis::FrameAnalysis() : frameSize(0, 0) {
+}
+
+FrameAnalysis::FrameAnalysis(cv::Size frameSize, std::vector<std::vector<cv::Point>> contours, std::vector<double> areas)
+    : frameSize(frameSize), contours(std::move(contours)) {
+
+    CV_Assert(this->contours.size() == areas.size());
+
+    ScratchArena arena;
+    stats.compute(this->contours, arena);
+    stats.areas = std::move(areas);
+}
+
+void FrameAnalysis::assign(cv::Size frameSize, std::vector<std::vector<cv::Point>>& rawContours, double minArea, ScratchArena& arena) {
+    TRACE_SCOPE("contour_stats");
+    this->frameSize = frameSize;
+
+    // Statistics of every raw contour in one parallel pass, then the small ones are dropped
+    stats.compute(rawContours, arena);
+
+    size_t count = 0;
+    for (size_t i = 0; i < rawContours.size(); i++) {
+        if (stats.areas[i] < minArea) {
+            continue;
+        }
+
+        if (count == contours.size()) {
+            arena.resize(contours, count + 1);
+        }
+
+        std::swap(contours[count], rawContours[i]);
+        stats.moveRow(i, count);
+        count++;
+    }
+
+    contours.resize(count);
+    stats.resize(count, arena);
+}
+
+void FrameAnalysis::assign(cv::Size frameSize, std::vector<std::vector<cv::Point>>& objectContours, const std::vector<double>& objectAreas,
+    const std::vector<cv::Point2f>& objectCentroids, const std::vector<cv::Rect>& objectBoxes, ScratchArena& arena) {
+    this->frameSize = frameSize;
+
+    size_t count = objectContours.size();
+    arena.resize(contours, count);
+    for (size_t i = 0; i < count; i++) {
+        std::swap(contours[i], objectContours[i]);
+    }
+
+    // Moments from the object's own area and centroid, so getMoments gives the same center as getCentroid
+    stats.compute(contours, arena);
+    for (size_t i = 0; i < count; i++) {
+        stats.areas[i] = objectAreas[i];
+        stats.centroidX[i] = objectCentroids[i].x;
+        stats.centroidY[i] = objectCentroids[i].y;
+        stats.m00[i] = objectAreas[i];
+        stats.m10[i] = objectCentroids[i].x * objectAreas[i];
+        stats.m01[i] = objectCentroids[i].y * objectAreas[i];
+        stats.boxX[i] = objectBoxes[i].x;
+        stats.boxY[i] = objectBoxes[i].y;
+        stats.boxWidth[i] = objectBoxes[i].width;
+        stats.boxHeight[i] = objectBoxes[i].height;
+    }
+}
+
+cv::Size FrameAnalysis::getFrameSize() const {
+    return frameSize;
+}
+
+int FrameAnalysis::getObjectCount() const {
+    return static_cast<int>(contours.size());
+}
+
+bool FrameAnalysis::empty() const {
+    return contours.empty();
+}
+
+const std::vector<std::vector<cv::Point>>& FrameAnalysis::getContours() const {
+    return contours;
+}
+
+const std::vector<cv::Point>& FrameAnalysis::getContour(int index) const {
+    return contours[index];
+}
+
+cv::Moments FrameAnalysis::getMoments(int index) const {
+    cv::Moments moments;
+    moments.m00 = stats.m00[index];
+    moments.m10 = stats.m10[index];
+    moments.m01 = stats.m01[index];
+
+    return moments;
+}
+
+double FrameAnalysis::getArea(int index) const {
+    return stats.areas[index];
+}
+
+cv::Point2f FrameAnalysis::getCentroid(int index) const {
+    return cv::Point2f(stats.centroidX[index], stats.centroidY[index]);
+}
+
+cv::Rect FrameAnalysis::getBoundingBox(int index) const {
+    return cv::Rect(stats.boxX[index], stats.boxY[index], stats.boxWidth[index], stats.boxHeight[index]);
+}
+
+double FrameAnalysis::getPerimeter(int index) const {
+    return stats.perimeters[index];
+}
+
+const ContourStats& FrameAnalysis::getStats() const {
+    return stats;
+}
+
+ObjectRecord FrameAnalysis::getRecord(int index, uint32_t imageId) const {
+    ObjectRecord record = {};
+    record.imageId = imageId;
+    record.objectId = -1;
+
+    if (index < 0) {
+        return record;
+    }
+
+    record.objectId = index;
+    record.area = stats.areas[index];
+    record.centroidX = stats.centroidX[index];
+    record.centroidY = stats.centroidY[index];
+    record.boxX = stats.boxX[index];
+    record.boxY = stats.boxY[index];
+    record.boxWidth = stats.boxWidth[index];
+    record.boxHeight = stats.boxHeight[index];
+    record.contourPoints = static_cast<uint32_t>(contours[index].size());
+
+    return record;
+}
+
+int FrameAnalysis::findCenterObject() const {
+    // Find the contour corresponding to the object in the center
+    cv::Point2f imageCenter(static_cast<float>(frameSize.width / 2), static_cast<float>(frameSize.height / 2));
+    return stats.findNearestCentroid(imageCenter);
+}
+
+int FrameAnalysis::findObjectAt(cv::Point point) const {
+    // Check if the specific pixel is within any contour
+    for (size_t i = 0; i < contours.size(); i++) {
+        // Points outside the bounding box cannot be inside the contour
+        if (point.x < stats.boxX[i] || point.y < stats.boxY[i] || point.x >= stats.boxX[i] + stats.boxWidth[i] || point.y >= stats.boxY[i] + stats.boxHeight[i]) {
+            continue;
+        }
+
+        if (cv::pointPolygonTest(contours[i], point, false) >= 0) {
+            return static_cast<int>(i);
+        }
+    }
+
+    return -1;
+}
+
+cv::Mat FrameAnalysis::createLabelMap() const {
+    cv::Mat labelMap;
+    drawLabelMap(labelMap);
+
+    return labelMap;
+}
+
+void FrameAnalysis::drawLabelMap(cv::Mat& labelMap) const {
+    labelMap.create(frameSize, CV_32SC1);
+    labelMap.setTo(cv::Scalar(0));
+
+    // Fill in reverse order so the first contour wins where objects overlap, like findObjectAt
+    for (int i = getObjectCount() - 1; i >= 0; i--) {
+        cv::drawContours(labelMap, contours, i, cv::Scalar(i + 1), cv::FILLED);
+    }
+
+    // Rasterized edges can be a pixel off the real polygon, so pixels on a contour are left to the exact test
+    cv::drawContours(labelMap, contours, -1, cv::Scalar(-1), 3);
+}
+
+int FrameAnalysis::findObjectAt(const cv::Mat& labelMap, cv::Point point) const {
+    if (point.x < 0 || point.y < 0 || point.x >= labelMap.cols || point.y >= labelMap.rows) {
+        return -1;
+    }
+
+    int label = labelMap.at<int>(point.y, point.x);
+    if (label < 0) {
+        return findObjectAt(point);
+    }
+
+    return label - 1;
+}
+
+std::vector<PointQueryResult> FrameAnalysis::findObjectsAt(const std::vector<cv::Point>& points) const {
+    cv::Mat labelMap;
+    return findObjectsAt(points, labelMap);
+}
+
+std::vector<PointQueryResult> FrameAnalysis::findObjectsAt(const std::vector<cv::Point>& points, cv::Mat& labelMap) const {
+    std::vector<PointQueryResult> results;
+    results.reserve(points.size());
+
+    if (points.empty()) {
+        return results;
+    }
+
+    drawLabelMap(labelMap);
+
+    for (const auto& point : points) {
+        PointQueryResult result;
+        result.objectId = findObjectAt(labelMap, point);
+        result.area = 0;
+        result.centroid = cv::Point2f(-1, -1);
+
+        if (result.objectId > -1) {
+            result.area = stats.areas[result.objectId];
+            result.centroid = getCentroid(result.objectId);
+        }
+
+        results.push_back(result);
+    }
+
+    return results;
+}
@@ -0,0 +1,100 @@
+#ifndef FRAMEANALYSIS_HPP
+#define FRAMEANALYSIS_HPP
+
+#include <opencv2/opencv.hpp>
+#include <cstdint>
+#include <vector>
+#include "ContourStats.hpp"
+#include "ScratchArena.hpp"
+using namespace cv;
+
+// Object found for a query point, objectId is -1 when the point is not inside any object
+struct PointQueryResult {
+    int objectId;
+    double area;
+    cv::Point2f centroid;
+};
+
+// Plain copyable summary of one object, for writing results without the contour or the image.
+// The contour stays in the FrameAnalysis it came from, at index objectId.
+struct ObjectRecord {
+    // Caller-chosen id of the image, e.g. its index in a batch
+    uint32_t imageId;
+    // Index in the analysis, -1 when there is no object
+    int32_t objectId;
+    double area;
+    float centroidX;
+    float centroidY;
+    int32_t boxX;
+    int32_t boxY;
+    int32_t boxWidth;
+    int32_t boxHeight;
+    uint32_t contourPoints;
+};
+
+// Result of running the detection pipeline once on an image.
+// Holds the filtered contours together with their statistics (see ContourStats) so that
+// several queries on the same image share one pipeline pass.
+class FrameAnalysis {
+public:
+    FrameAnalysis();
+    FrameAnalysis(cv::Size frameSize, std::vector<std::vector<cv::Point>> contours, std::vector<double> areas);
+
+    cv::Size getFrameSize() const;
+    int getObjectCount() const;
+    bool empty() const;
+
+    const std::vector<std::vector<cv::Point>>& getContours() const;
+    const std::vector<cv::Point>& getContour(int index) const;
+    // Only the spatial moments m00, m10 and m01 are filled
+    cv::Moments getMoments(int index) const;
+    double getArea(int index) const;
+    cv::Point2f getCentroid(int index) const;
+    cv::Rect getBoundingBox(int index) const;
+    double getPerimeter(int index) const;
+
+    // All statistics, one column per value
+    const ContourStats& getStats() const;
+
+    // Summary of the object at index, or an empty record with objectId -1 when index is -1
+    ObjectRecord getRecord(int index, uint32_t imageId) const;
+
+    // Index of the object whose centroid is closest to the image center, -1 if there is none
+    int findCenterObject() const;
+
+    // Index of the first object containing the point, -1 if there is none
+    int findObjectAt(cv::Point point) const;
+
+    // Rasterizes all objects into a CV_32S image holding index + 1 for every pixel inside an object,
+    // 0 for background and -1 for pixels close enough to a contour that they need the exact polygon test
+    cv::Mat createLabelMap() const;
+    void drawLabelMap(cv::Mat& labelMap) const;
+
+    // Same result as findObjectAt(point) but answered from a map made by createLabelMap
+    int findObjectAt(const cv::Mat& labelMap, cv::Point point) const;
+
+    // Resolves every point with one label map instead of testing each point against every contour
+    std::vector<PointQueryResult> findObjectsAt(const std::vector<cv::Point>& points) const;
+    std::vector<PointQueryResult> findObjectsAt(const std::vector<cv::Point>& points, cv::Mat& labelMap) const;
+
+private:
+    friend class ObjectDetection;
+    friend class CannyContourBackend;
+    friend class ThresholdComponentsBackend;
+
+    // Refills the analysis from freshly found contours, reusing the memory of the previous frame.
+    // Accepted contours are swapped out of rawContours instead of copied.
+    void assign(cv::Size frameSize, std::vector<std::vector<cv::Point>>& rawContours, double minArea, ScratchArena& arena);
+
+    // Refills the analysis from already filtered objects whose area, centroid and bounding box are known,
+    // e.g. from connectedComponentsWithStats. Those replace the values computed from the contours, and
+    // m00, m10 and m01 are derived from them.
+    void assign(cv::Size frameSize, std::vector<std::vector<cv::Point>>& objectContours, const std::vector<double>& objectAreas,
+        const std::vector<cv::Point2f>& objectCentroids, const std::vector<cv::Rect>& objectBoxes, ScratchArena& arena);
+
+    cv::Size frameSize;
+    std::vector<std::vector<cv::Point>> contours;
+    ContourStats stats;
+};
+
+#endif // FRAMEANALYSIS_HPP
\ No newline at end of file
@@ -0,0 +1,85 @@
+#include "HSVRangeMask.hpp"
+#include <algorithm>
+
+HueRange HueRange::around(int hue, int tolerance) {
+    // A tolerance of 90 or more covers every hue
+    if (2 * tolerance + 1 >= 180) {
+        return HueRange(0, 179);
+    }
+
+    int minHue = ((hue - tolerance) % 180 + 180) % 180;
+    int maxHue = (hue + tolerance) % 180;
+
+    return HueRange(minHue, maxHue);
+}
+
+HSVRangeMask::HSVRangeMask(const std::vector<HueRange>& hueRanges, int minSaturation, int maxSaturation, int minValue, int maxValue) {
+    // Wrapped hue ranges are split at 180; hues 180 and above never come out of BGR2HSV
+    for (const HueRange& range : hueRanges) {
+        for (int hue = 0; hue < 180; hue++) {
+            bool inside = range.minHue <= range.maxHue
+                ? hue >= range.minHue && hue <= range.maxHue
+                : hue >= range.minHue || hue <= range.maxHue;
+            hueSelected[hue] |= inside ? 1 : 0;
+        }
+    }
+
+    for (int i = 0; i < 256; i++) {
+        saturationSelected[i] = i >= minSaturation && i <= maxSaturation ? 1 : 0;
+        valueSelected[i] = i >= minValue && i <= maxValue ? 1 : 0;
+    }
+}
+
+bool HSVRangeMask::contains(const cv::Vec3b& bgr) const {
+    cv::Mat hsv;
+    cv::cvtColor(cv::Mat(1, 1, CV_8UC3, cv::Scalar(bgr[0], bgr[1], bgr[2])), hsv, cv::COLOR_BGR2HSV);
+    const cv::Vec3b& pixel = hsv.at<cv::Vec3b>(0, 0);
+
+    return hueSelected[pixel[0]] && saturationSelected[pixel[1]] && valueSelected[pixel[2]];
+}
+
+void HSVRangeMask::apply(const cv::Mat& image, cv::Mat& mask) const {
+    apply(image, mask, nullptr);
+}
+
+void HSVRangeMask::apply(const cv::Mat& image, cv::Mat& mask, cv::Mat& masked) const {
+    apply(image, mask, &masked);
+}
+
+void HSVRangeMask::apply(const cv::Mat& image, cv::Mat& mask, cv::Mat* masked) const {
+    CV_Assert(image.type() == CV_8UC3);
+
+    mask.create(image.size(), CV_8UC1);
+    if (masked) {
+        masked->create(image.size(), CV_8UC3);
+    }
+
+    // Rows are independent, so they are split across threads. Each thread converts a strip of rows at a
+    // time, small enough for the HSV strip to still be in cache when it is checked.
+    const int stripPixels = 16384;
+    int stripRows = std::max(1, stripPixels / std::max(image.cols, 1));
+
+    cv::parallel_for_(cv::Range(0, image.rows), [&](const cv::Range& range) {
+        cv::Mat hsv;
+
+        for (int top = range.start; top < range.end; top += stripRows) {
+            int bottom = std::min(top + stripRows, range.end);
+            cv::cvtColor(image.rowRange(top, bottom), hsv, cv::COLOR_BGR2HSV);
+
+            for (int y = top; y < bottom; y++) {
+                const cv::Vec3b* pixels = image.ptr<cv::Vec3b>(y);
+                const cv::Vec3b* hsvRow = hsv.ptr<cv::Vec3b>(y - top);
+                uchar* maskRow = mask.ptr<uchar>(y);
+                cv::Vec3b* maskedRow = masked ? masked->ptr<cv::Vec3b>(y) : nullptr;
+
+                for (int x = 0; x < image.cols; x++) {
+                    bool inside = hueSelected[hsvRow[x][0]] && saturationSelected[hsvRow[x][1]] && valueSelected[hsvRow[x][2]];
+                    maskRow[x] = inside ? 255 : 0;
+                    if (maskedRow) {
+                        maskedRow[x] = inside ? pixels[x] : cv::Vec3b(0, 0, 0);
+                    }
+                }
+            }
+        }
+    });
+}
@@ -0,0 +1,47 @@
+#ifndef HSVRANGEMASK_HPP
+#define HSVRANGEMASK_HPP
+
+#include <opencv2/opencv.hpp>
+#include <vector>
+using namespace cv;
+
+// Inclusive range of 8-bit OpenCV hues (0-179). A range with minHue > maxHue wraps around
+// red, so HueRange(175, 3) covers 175-179 and 0-3.
+struct HueRange {
+    HueRange(int minHue, int maxHue) : minHue(minHue), maxHue(maxHue) {
+    }
+
+    // Range of hue - tolerance to hue + tolerance, wrapping around 0/180 when needed
+    static HueRange around(int hue, int tolerance);
+
+    int minHue;
+    int maxHue;
+};
+
+// Colour segmentation by any number of hue ranges plus saturation and value bounds, giving the
+// same mask as cvtColor(BGR2HSV) followed by one inRange per hue range OR'd together.
+// The bounds are kept as one 256-entry table per channel, so building an instance is free. apply
+// converts a few rows at a time into a small per-thread HSV buffer and checks them against the tables
+// while the rows are still in cache, writing the mask (and optionally the masked image) in that pass.
+class HSVRangeMask {
+public:
+    HSVRangeMask(const std::vector<HueRange>& hueRanges, int minSaturation, int maxSaturation, int minValue, int maxValue);
+
+    // Writes 255 into mask where the BGR pixel is inside the bounds and 0 elsewhere
+    void apply(const cv::Mat& image, cv::Mat& mask) const;
+
+    // Also writes the pixels inside the bounds into masked and zeroes the rest, like bitwise_and with the mask
+    void apply(const cv::Mat& image, cv::Mat& mask, cv::Mat& masked) const;
+
+    bool contains(const cv::Vec3b& bgr) const;
+
+private:
+    // Non-zero for the hues, saturations and values inside the bounds
+    uchar hueSelected[256] = {};
+    uchar saturationSelected[256] = {};
+    uchar valueSelected[256] = {};
+
+    void apply(const cv::Mat& image, cv::Mat& mask, cv::Mat* masked) const;
+};
+
+#endif // HSVRANGEMASK_HPP
@@ -0,0 +1,143 @@
+#include "ImageSource.hpp"
+#include <iostream>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+ImageSource::ImageSource(size_t capacityBytes) : capacityBytes(capacityBytes) {
+}
+
+int ImageSource::getReduction(const DecodeRequest& request) {
+    if (request.maxReduction >= 8) {
+        return 8;
+    }
+    if (request.maxReduction >= 4) {
+        return 4;
+    }
+    if (request.maxReduction >= 2) {
+        return 2;
+    }
+    return 1;
+}
+
+int ImageSource::getDecodeFlags(const DecodeRequest& request) {
+    switch (getReduction(request)) {
+    case 8:
+        return request.color ? cv::IMREAD_REDUCED_COLOR_8 : cv::IMREAD_REDUCED_GRAYSCALE_8;
+    case 4:
+        return request.color ? cv::IMREAD_REDUCED_COLOR_4 : cv::IMREAD_REDUCED_GRAYSCALE_4;
+    case 2:
+        return request.color ? cv::IMREAD_REDUCED_COLOR_2 : cv::IMREAD_REDUCED_GRAYSCALE_2;
+    default:
+        return request.color ? cv::IMREAD_COLOR : cv::IMREAD_GRAYSCALE;
+    }
+}
+
+bool ImageSource::getFileStamp(const std::string& path, FileStamp& stamp) {
+    struct stat info;
+    if (stat(path.c_str(), &info) != 0) {
+        return false;
+    }
+
+    // Whole seconds would miss a file rewritten within the same second
+#if defined(_WIN32)
+    stamp.modified = static_cast<long long>(info.st_mtime) * 1000000000LL;
+#elif defined(__APPLE__)
+    stamp.modified = static_cast<long long>(info.st_mtimespec.tv_sec) * 1000000000LL + info.st_mtimespec.tv_nsec;
+#else
+    stamp.modified = static_cast<long long>(info.st_mtim.tv_sec) * 1000000000LL + info.st_mtim.tv_nsec;
+#endif
+    stamp.fileSize = static_cast<long long>(info.st_size);
+    stamp.fileId = static_cast<long long>(info.st_ino);
+    return true;
+}
+
+void ImageSource::evict(std::list<Entry>::iterator entry) {
+    cachedBytes -= entry->image.total() * entry->image.elemSize();
+    index.erase(entry->key);
+    entries.erase(entry);
+}
+
+cv::Mat ImageSource::read(const std::string& path, const DecodeRequest& request) {
+    int flags = getDecodeFlags(request);
+
+    FileStamp stamp;
+    if (!getFileStamp(path, stamp)) {
+        std::cerr << "Error: Could not open the image file " << path << std::endl;
+        return cv::Mat();
+    }
+
+    std::string key = std::to_string(flags) + ":" + path;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        auto found = index.find(key);
+        if (found != index.end()) {
+            if (found->second->stamp == stamp) {
+                hits++;
+                entries.splice(entries.begin(), entries, found->second);
+                return found->second->image;
+            }
+
+            // The file changed since it was decoded
+            evict(found->second);
+        }
+        misses++;
+    }
+
+    // Decode without holding the lock so other threads can use the cache meanwhile
+    cv::Mat image = cv::imread(path, flags);
+    if (image.empty()) {
+        std::cerr << "Error: Could not decode the image file " << path << std::endl;
+        return image;
+    }
+
+    size_t bytes = image.total() * image.elemSize();
+    if (bytes > capacityBytes) {
+        return image;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+
+    // Another thread may have decoded the same file in the meantime
+    auto found = index.find(key);
+    if (found != index.end()) {
+        evict(found->second);
+    }
+
+    while (cachedBytes + bytes > capacityBytes && !entries.empty()) {
+        evict(std::prev(entries.end()));
+    }
+
+    Entry entry;
+    entry.key = key;
+    entry.image = image;
+    entry.stamp = stamp;
+    entries.push_front(std::move(entry));
+    index[key] = entries.begin();
+    cachedBytes += bytes;
+
+    return image;
+}
+
+void ImageSource::clear() {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    entries.clear();
+    index.clear();
+    cachedBytes = 0;
+}
+
+size_t ImageSource::getHitCount() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return hits;
+}
+
+size_t ImageSource::getMissCount() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return misses;
+}
+
+size_t ImageSource::getCachedBytes() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return cachedBytes;
+}
@@ -0,0 +1,80 @@
+#ifndef IMAGESOURCE_HPP
+#define IMAGESOURCE_HPP
+
+#include <opencv2/opencv.hpp>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+using namespace cv;
+
+// What a caller needs from a decoded image, so the cheapest decode mode can be picked
+struct DecodeRequest {
+    // False when only the edge map or areas are needed; grayscale decoding skips the color conversion
+    bool color = true;
+
+    // Largest downscale factor (1, 2, 4 or 8) the caller accepts, e.g. 2^levels for a pyramid query.
+    // JPEG decoders can skip most of the work for reduced sizes.
+    int maxReduction = 1;
+};
+
+// Reads images from disk with the cheapest cv::imread mode for a DecodeRequest, and keeps recently
+// decoded images in an LRU cache keyed by path and decode mode. A cached image is used only while
+// the file's modification time, size and inode are unchanged, so repeated queries on one file skip decoding.
+// Modification times have nanosecond resolution where the platform provides it (not on Windows).
+// Safe to use from several threads.
+class ImageSource {
+public:
+    // Cache budget in bytes of decoded pixels; 0 disables caching
+    explicit ImageSource(size_t capacityBytes = 256 * 1024 * 1024);
+
+    // The returned image shares its pixels with the cache, so clone it before drawing into it.
+    // Empty if the file cannot be read.
+    cv::Mat read(const std::string& path, const DecodeRequest& request = DecodeRequest());
+
+    // cv::imread flags for a request
+    static int getDecodeFlags(const DecodeRequest& request);
+
+    // Downscale factor of the flags returned by getDecodeFlags
+    static int getReduction(const DecodeRequest& request);
+
+    void clear();
+
+    size_t getHitCount() const;
+    size_t getMissCount() const;
+    size_t getCachedBytes() const;
+
+private:
+    // One version of a file; a file replaced by rename gets a new inode even within the same time stamp
+    struct FileStamp {
+        long long modified = 0;
+        long long fileSize = 0;
+        long long fileId = 0;
+
+        bool operator==(const FileStamp& other) const {
+            return modified == other.modified && fileSize == other.fileSize && fileId == other.fileId;
+        }
+    };
+
+    struct Entry {
+        std::string key;
+        cv::Mat image;
+        FileStamp stamp;
+    };
+
+    size_t capacityBytes;
+    size_t cachedBytes = 0;
+    size_t hits = 0;
+    size_t misses = 0;
+
+    // Most recently used first
+    std::list<Entry> entries;
+    std::unordered_map<std::string, std::list<Entry>::iterator> index;
+
+    mutable std::mutex mutex;
+
+    static bool getFileStamp(const std::string& path, FileStamp& stamp);
+    void evict(std::list<Entry>::iterator entry);
+};
+
+#endif // IMAGESOURCE_HPP
@@ -0,0 +1,129 @@
+#include "MaxFilter.hpp"
+#include <opencv2/core/hal/intrin.hpp>
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+namespace {
+    // output[x] = max(a[x], b[x])
+    void maxRow(const uchar* a, const uchar* b, uchar* output, int width) {
+        int x = 0;
+#if CV_SIMD128
+        for (; x <= width - 16; x += 16) {
+            cv::v_store(output + x, cv::v_max(cv::v_load(a + x), cv::v_load(b + x)));
+        }
+#endif
+        for (; x < width; x++) {
+            output[x] = std::max(a[x], b[x]);
+        }
+    }
+
+    // Buffers kept per thread, so parallel bands neither share nor reallocate them
+    struct MaxFilterBuffers {
+        // Running maxima of whole rows for the vertical pass
+        std::vector<uchar> verticalForward;
+        std::vector<uchar> verticalBackward;
+        std::vector<uchar> zeros;
+        // One row of the vertical result, then its padded copy and running maxima for the horizontal pass
+        std::vector<uchar> columnMax;
+        std::vector<uchar> padded;
+        std::vector<uchar> horizontalForward;
+        std::vector<uchar> horizontalBackward;
+    };
+
+    MaxFilterBuffers& getThreadBuffers() {
+        thread_local MaxFilterBuffers buffers;
+        return buffers;
+    }
+
+    // Maximum over windows of 1 + 2 * radius along one row, outside pixels counting as 0.
+    // Forward and backward running maxima restart at every block of the window size, so any
+    // window is covered by the backward maximum at its start and the forward maximum at its end.
+    void maxFilterRow(const uchar* input, uchar* output, int width, int radius, MaxFilterBuffers& buffers) {
+        int window = 2 * radius + 1;
+        int length = width + 2 * radius;
+
+        buffers.padded.resize(length);
+        buffers.horizontalForward.resize(length);
+        buffers.horizontalBackward.resize(length);
+
+        uchar* values = buffers.padded.data();
+        std::memset(values, 0, radius);
+        std::memcpy(values + radius, input, width);
+        std::memset(values + radius + width, 0, radius);
+
+        uchar* forward = buffers.horizontalForward.data();
+        uchar* backward = buffers.horizontalBackward.data();
+        for (int start = 0; start < length; start += window) {
+            int end = std::min(start + window, length);
+
+            forward[start] = values[start];
+            for (int i = start + 1; i < end; i++) {
+                forward[i] = std::max(forward[i - 1], values[i]);
+            }
+            backward[end - 1] = values[end - 1];
+            for (int i = end - 2; i >= start; i--) {
+                backward[i] = std::max(backward[i + 1], values[i]);
+            }
+        }
+
+        maxRow(backward, forward + window - 1, output, width);
+    }
+}
+
+void dilateSquare(const cv::Mat& source, cv::Mat& output, int radius) {
+    // In place works too: the vertical pass has read every source row before the first output row is written
+    output.create(source.size(), CV_8UC1);
+    dilateSquareRows(source, 0, source.rows, radius, output);
+}
+
+void dilateSquareRows(const cv::Mat& source, int top, int bottom, int radius, cv::Mat& output) {
+    CV_Assert(source.type() == CV_8UC1 && output.type() == CV_8UC1);
+    CV_Assert(top >= 0 && bottom <= source.rows && output.rows == bottom - top && output.cols == source.cols);
+
+    int width = source.cols;
+    int rows = bottom - top;
+    if (radius <= 0) {
+        source.rowRange(top, bottom).copyTo(output);
+        return;
+    }
+
+    // Vertical pass over the rows of the range plus radius rows on either side, rows outside the image
+    // counting as 0. Every step combines whole rows, so it vectorizes across the columns.
+    MaxFilterBuffers& buffers = getThreadBuffers();
+    int window = 2 * radius + 1;
+    int length = rows + 2 * radius;
+
+    buffers.zeros.assign(width, 0);
+    buffers.verticalForward.resize(static_cast<size_t>(length) * width);
+    buffers.verticalBackward.resize(static_cast<size_t>(length) * width);
+    uchar* forward = buffers.verticalForward.data();
+    uchar* backward = buffers.verticalBackward.data();
+
+    auto inputRow = [&](int i) {
+        int y = top - radius + i;
+        return (y < 0 || y >= source.rows) ? buffers.zeros.data() : source.ptr<uchar>(y);
+    };
+
+    for (int start = 0; start < length; start += window) {
+        int end = std::min(start + window, length);
+
+        std::memcpy(forward + static_cast<size_t>(start) * width, inputRow(start), width);
+        for (int i = start + 1; i < end; i++) {
+            uchar* row = forward + static_cast<size_t>(i) * width;
+            maxRow(row - width, inputRow(i), row, width);
+        }
+        std::memcpy(backward + static_cast<size_t>(end - 1) * width, inputRow(end - 1), width);
+        for (int i = end - 2; i >= start; i--) {
+            uchar* row = backward + static_cast<size_t>(i) * width;
+            maxRow(row + width, inputRow(i), row, width);
+        }
+    }
+
+    // Output row y covers padded rows [y, y + window); then the horizontal pass on that column maximum
+    buffers.columnMax.resize(width);
+    for (int y = 0; y < rows; y++) {
+        maxRow(backward + static_cast<size_t>(y) * width, forward + static_cast<size_t>(y + window - 1) * width, buffers.columnMax.data(), width);
+        maxFilterRow(buffers.columnMax.data(), output.ptr<uchar>(y), width, radius, buffers);
+    }
+}
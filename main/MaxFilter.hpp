@@ -0,0 +1,22 @@
+#ifndef MAXFILTER_HPP
+#define MAXFILTER_HPP
+
+#include <opencv2/opencv.hpp>
+using namespace cv;
+
+// Dilation of a CV_8UC1 image by a (2 * radius + 1) square, bit for bit the same as
+// cv::dilate(source, output, cv::Mat(), cv::Point(-1, -1), radius) with the default 3x3 element.
+// cv::dilate already merges those iterations into one separable pass with a (2 * radius + 1) rect,
+// which costs 2 * radius + 1 comparisons per pixel and direction. This uses the van Herk/Gil-Werman
+// max filter instead: a running maximum forwards and backwards within blocks of the window size, then
+// one maximum of the two per pixel, in each direction. That is about three comparisons per pixel and
+// direction whatever the radius. The vertical pass and the final maximum of each row use OpenCV's SIMD
+// intrinsics; the horizontal running maxima are sequential and stay scalar.
+void dilateSquare(const cv::Mat& source, cv::Mat& output, int radius);
+
+// Rows [top, bottom) of the dilation above, written into output (bottom - top rows, allocated by the
+// caller). Rows of source outside the range are read as neighbours, like cv::dilate on a row view,
+// so bands of one image can be dilated in parallel.
+void dilateSquareRows(const cv::Mat& source, int top, int bottom, int radius, cv::Mat& output);
+
+#endif // MAXFILTER_HPP
@@ -1,4 +1,6 @@
 #include "ObjectDetection.hpp"
+#include "Tracing.hpp"
+#include <limits>
 
 double ObjectDetection::getArea() {
     return areaInfo;
@@ -12,147 +14,498 @@ cv::Point ObjectDetection::getCenter() {
     return centerInfo;
 }
 
-void ObjectDetection::drawWeightedContour(cv::Mat image, std::vector<cv::Point> contour) {
-    cv::Mat mask = cv::Mat::zeros(image.size(), CV_8UC1);
-    std::vector<std::vector<cv::Point>> contours = { contour };
-    cv::drawContours(mask, contours, -1, cv::Scalar(255), cv::FILLED);
-
-    // Create an opaque version of the original image
-    cv::Mat overlayedImage = image.clone();
+size_t ObjectDetection::getAllocationCount() const {
+    return scratch.arena.getAllocationCount() + scratch.preprocessor.getAllocationCount() + overlay.getAllocationCount()
+        + scratch.cannyContours.getAllocationCount() + scratch.thresholdComponents.getAllocationCount();
+}
 
-    // Apply the mask to the overlayed image
-    overlayedImage.setTo(contourColor, mask);
+ObjectDetection::Scratch& ObjectDetection::getThreadScratch() {
+    // One set per thread, shared by all instances used on that thread
+    static thread_local Scratch buffers;
+    return buffers;
+}
 
-    // Blend the overlayed image with the original image
-    double alpha = 0.4;
-    cv::addWeighted(overlayedImage, alpha, image, 1.0 - alpha, 0, image);
-    cv::drawContours(image, contours, -1, contourColor, 1 + ((image.rows + image.cols) / 400));
+void ObjectDetection::drawWeightedContour(cv::Mat image, const std::vector<std::vector<cv::Point>>& contours, int index) {
+    // Blends only inside the contour's bounding box, see OverlayRenderer
+    overlay.color = contourColor;
+    overlay.draw(image, contours, index);
 }
 
 cv::Mat ObjectDetection::getEdges(cv::Mat image) {
-    cv::Mat gray;
-    cv::cvtColor(image, gray, cv::COLOR_BGR2GRAY);
+    // Grayscale, Canny and dilation run fused in row bands, see EdgePreprocessor
+    cv::Mat dilatedEdges;
+    scratch.preprocessor.process(image, dilatedEdges, 2 + ((image.rows + image.cols) / 1500));
+
+    return dilatedEdges;
+}
 
-    cv::Mat blurredImage;
-    cv::GaussianBlur(gray, blurredImage, cv::Size(1, 1), 0, 0);
+FrameAnalysis ObjectDetection::analyze(const cv::Mat& image) {
+    FrameAnalysis analysis;
+    analyze(image, analysis);
 
-    // Apply Canny edge detection
-    cv::Mat edges;
-    cv::Canny(blurredImage, edges, 50, 135);
+    return analysis;
+}
 
-    cv::Mat dilatedEdges;
-    cv::dilate(edges, dilatedEdges, cv::Mat(), cv::Point(-1, -1), 2 + ((image.rows + image.cols) / 1500));
+void ObjectDetection::analyze(const cv::Mat& image, FrameAnalysis& analysis) {
+    segment(image, analysis, segmentationMethod, scratch);
+}
 
-    return dilatedEdges;
+FrameAnalysis ObjectDetection::analyze(const cv::Mat& image, SegmentationMethod method) {
+    FrameAnalysis analysis;
+    analyze(image, analysis, method);
+
+    return analysis;
 }
 
-std::vector<std::vector<cv::Point>> ObjectDetection::getContours(cv::Mat& image) {
+void ObjectDetection::analyze(const cv::Mat& image, FrameAnalysis& analysis, SegmentationMethod method) {
+    segment(image, analysis, method, scratch);
+}
+
+void ObjectDetection::analyze(const cv::Mat& image, FrameAnalysis& analysis, SegmentationBackend& backend) {
+    backend.segment(image, minArea, analysis);
+}
 
-    cv::Mat gray;
-    cv::cvtColor(image, gray, cv::COLOR_BGR2GRAY);
+void ObjectDetection::segment(const cv::Mat& image, FrameAnalysis& analysis, SegmentationMethod method, Scratch& buffers) const {
+    TRACE_COUNT("frames", 1);
+    if (method == SegmentationMethod::ThresholdComponents) {
+        buffers.thresholdComponents.segment(image, minArea, analysis);
+    }
+    else {
+        buffers.cannyContours.segment(image, minArea, analysis);
+    }
+}
 
-    // Threshold the grayscale image to create a binary mask
-    cv::Mat blurredImage;
-    cv::GaussianBlur(gray, blurredImage, cv::Size(1, 1), 0, 0);
+void ObjectDetection::setPyramidLevels(int levels) {
+    pyramidLevels = levels;
+}
 
-    // Apply Canny edge detection
-    cv::Mat edges;
-    cv::Canny(blurredImage, edges, 50, 135);
+int ObjectDetection::getPyramidLevels() const {
+    return pyramidLevels;
+}
 
-    // Apply dilation to enhance edges
-    cv::Mat dilatedEdges;
-    cv::dilate(edges, dilatedEdges, cv::Mat(), cv::Point(-1, -1), 2 + ((image.rows + image.cols) / 1500));
+void ObjectDetection::analyzeCenterQuery(const cv::Mat& image, Scratch& buffers) const {
+    if (pyramidLevels > 0) {
+        analyzePyramid(image, true, cv::Point(-1, -1), buffers.frame, pyramidLevels, buffers);
+    }
+    else {
+        segment(image, buffers.frame, segmentationMethod, buffers);
+    }
+}
+
+void ObjectDetection::analyzePointQuery(const cv::Mat& image, cv::Point point, Scratch& buffers) const {
+    if (pyramidLevels > 0) {
+        analyzePyramid(image, false, point, buffers.frame, pyramidLevels, buffers);
+    }
+    else {
+        // Full frame, since a window can miss the larger outline enclosing the point; see analyzeAround
+        segment(image, buffers.frame, segmentationMethod, buffers);
+    }
+}
+
+void ObjectDetection::setSegmentationMethod(SegmentationMethod method) {
+    segmentationMethod = method;
+}
+
+SegmentationMethod ObjectDetection::getSegmentationMethod() const {
+    return segmentationMethod;
+}
+
+FrameAnalysis ObjectDetection::analyzeAround(const cv::Mat& image, cv::Point point) {
+    FrameAnalysis analysis;
+    analyzeAround(image, point, analysis);
+
+    return analysis;
+}
+
+void ObjectDetection::analyzeAround(const cv::Mat& image, cv::Point point, FrameAnalysis& analysis) {
+    traceAround(image, point, analysis, scratch);
+}
+
+void ObjectDetection::traceAround(const cv::Mat& image, cv::Point point, FrameAnalysis& analysis, Scratch& buffers) const {
+    // Otsu's threshold depends on the whole image, so only the Canny pipeline can work on a window
+    if (segmentationMethod != SegmentationMethod::CannyContours) {
+        segment(image, analysis, segmentationMethod, buffers);
+        return;
+    }
+
+    int radius = queryWindowSize / 2;
+    analyzeWindow(image, point, cv::Rect(point.x - radius, point.y - radius, 2 * radius + 1, 2 * radius + 1), analysis, buffers);
+}
+
+void ObjectDetection::analyzeWindow(const cv::Mat& image, cv::Point point, cv::Rect window, FrameAnalysis& analysis, Scratch& buffers) const {
+    std::vector<std::vector<cv::Point>>& rawContours = buffers.rawContours;
+
+    cv::Rect imageRect(0, 0, image.cols, image.rows);
+    if (!imageRect.contains(point)) {
+        rawContours.clear();
+        analysis.assign(image.size(), rawContours, minArea, buffers.arena);
+        return;
+    }
 
-    // Find contours in the mask
-    std::vector<std::vector<cv::Point>> contours; 
-    cv::findContours(dilatedEdges, contours, cv::RETR_EXTERNAL, cv::CHAIN_APPROX_SIMPLE);
+    // Same iteration count as the full frame, so the window sees the same edge map
+    int dilateIterations = 2 + ((image.rows + image.cols) / 1500);
+    int margin = buffers.preprocessor.getBorderMargin(dilateIterations);
 
-    std::vector<std::vector<cv::Point>> filteredContours;
-    int minArea = 2000;
+    while (true) {
+        window &= imageRect;
 
-    for (const auto& contour : contours) {
-        double area = contourArea(contour);
-        if (area >= minArea) {
-            filteredContours.push_back(contour);
+        // Preprocess a view padded by the margin so blur, Canny and dilate border effects stay outside the window
+        cv::Rect padded = cv::Rect(window.x - margin, window.y - margin, window.width + 2 * margin, window.height + 2 * margin) & imageRect;
+        buffers.preprocessor.process(image(padded), buffers.dilatedEdges, dilateIterations);
+        cv::findContours(buffers.dilatedEdges(window - padded.tl()), rawContours, cv::RETR_EXTERNAL, cv::CHAIN_APPROX_SIMPLE, window.tl());
+
+        int index = -1;
+        for (size_t i = 0; i < rawContours.size() && index < 0; i++) {
+            if (cv::boundingRect(rawContours[i]).contains(point) && cv::pointPolygonTest(rawContours[i], point, false) >= 0) {
+                index = static_cast<int>(i);
+            }
+        }
+
+        // The contour is complete once it stays clear of every window edge that is not an image edge
+        bool complete = window == imageRect;
+        if (index > -1) {
+            cv::Rect box = cv::boundingRect(rawContours[index]);
+            bool touchesBorder = (window.x > 0 && box.x <= window.x + 1)
+                || (window.y > 0 && box.y <= window.y + 1)
+                || (window.br().x < image.cols && box.br().x >= window.br().x - 1)
+                || (window.br().y < image.rows && box.br().y >= window.br().y - 1);
+            complete = complete || !touchesBorder;
+        }
+
+        if (complete) {
+            if (index > -1) {
+                std::swap(rawContours[0], rawContours[index]);
+                rawContours.resize(1);
+            }
+            else {
+                rawContours.clear();
+            }
+
+            analysis.assign(image.size(), rawContours, minArea, buffers.arena);
+            return;
         }
+
+        // Double the window around its center
+        window = cv::Rect(window.x - window.width / 2, window.y - window.height / 2, window.width * 2, window.height * 2);
     }
+}
 
-    return filteredContours;
+void ObjectDetection::analyzeCenterPyramid(const cv::Mat& image, FrameAnalysis& analysis, int levels) {
+    analyzePyramid(image, true, cv::Point(-1, -1), analysis, levels, scratch);
 }
 
-void ObjectDetection::findObjectInfo(cv::Mat image, int x, int y) {
-    imageInfo = image;
+void ObjectDetection::analyzeAroundPyramid(const cv::Mat& image, cv::Point point, FrameAnalysis& analysis, int levels) {
+    analyzePyramid(image, false, point, analysis, levels, scratch);
+}
 
-    // Create a point for the specific pixel
-    cv::Point point(x, y);
+void ObjectDetection::analyzePyramid(const cv::Mat& image, bool centerQuery, cv::Point point, FrameAnalysis& analysis, int levels, Scratch& buffers) const {
+    int factor = 1 << std::max(levels, 0);
+    cv::Size coarseSize(image.cols / factor, image.rows / factor);
 
-    std::vector<std::vector<cv::Point>> contours = getContours(image);
-    double area = 0;
-    cv::Point center(0, 0);
+    // Nothing to gain on small images, and only the Canny pipeline can be refined in a window
+    if (levels <= 0 || coarseSize.width < 64 || coarseSize.height < 64 || segmentationMethod != SegmentationMethod::CannyContours) {
+        if (centerQuery) {
+            segment(image, analysis, segmentationMethod, buffers);
+        }
+        else {
+            traceAround(image, point, analysis, buffers);
+        }
+        return;
+    }
 
-    // Check if the specific pixel is within any contour
-    for (const auto& contour : contours) {
-        if (cv::pointPolygonTest(contour, point, false) >= 0) {
+    // Find candidates on the downscaled image, with dilation and minimum area scaled to its resolution
+    buffers.arena.prepare(buffers.pyramidImage, coarseSize, image.type());
+    cv::resize(image, buffers.pyramidImage, coarseSize, 0, 0, cv::INTER_AREA);
+
+    int fullIterations = 2 + ((image.rows + image.cols) / 1500);
+    int coarseIterations = std::max(1, cvRound(static_cast<double>(fullIterations) / factor));
+    buffers.preprocessor.process(buffers.pyramidImage, buffers.dilatedEdges, coarseIterations);
+    cv::findContours(buffers.dilatedEdges, buffers.rawContours, cv::RETR_EXTERNAL, cv::CHAIN_APPROX_SIMPLE);
+
+    FrameAnalysis& coarse = buffers.coarse;
+    coarse.assign(coarseSize, buffers.rawContours, static_cast<double>(minArea) / (factor * factor), buffers.arena);
+
+    int index = centerQuery ? coarse.findCenterObject() : coarse.findObjectAt(cv::Point(point.x / factor, point.y / factor));
+    if (index < 0) {
+        buffers.rawContours.clear();
+        analysis.assign(image.size(), buffers.rawContours, minArea, buffers.arena);
+        return;
+    }
+
+    // Start inside the chosen object: the clicked point, or the scaled-up centroid when it lies inside the coarse contour.
+    // For a ring or crescent shape whose centroid falls outside, the coarse pixel farthest from its outline is used instead.
+    cv::Rect box = coarse.getBoundingBox(index);
+    cv::Point seed = point;
+    if (centerQuery) {
+        cv::Point centroid(coarse.getCentroid(index));
+        if (coarse.findObjectAt(centroid) != index) {
+            // One pixel of background around the box, so the outline counts as the object's edge everywhere
+            cv::Point offset = box.tl() - cv::Point(1, 1);
+            cv::Size maskSize(box.width + 2, box.height + 2);
+            buffers.arena.prepare(buffers.seedMask, maskSize, CV_8UC1);
+            buffers.arena.prepare(buffers.seedDistance, maskSize, CV_32FC1);
+            buffers.seedMask.setTo(cv::Scalar(0));
+            cv::drawContours(buffers.seedMask, coarse.getContours(), index, cv::Scalar(255), cv::FILLED, cv::LINE_8, cv::noArray(),
+                std::numeric_limits<int>::max(), -offset);
+            cv::distanceTransform(buffers.seedMask, buffers.seedDistance, cv::DIST_L2, 3);
+
+            cv::Point deepest;
+            cv::minMaxLoc(buffers.seedDistance, nullptr, nullptr, nullptr, &deepest);
+            centroid = deepest + offset;
+        }
+
+        // Middle of the full-resolution block the coarse pixel came from
+        seed = centroid * factor + cv::Point(factor / 2, factor / 2);
+        seed = cv::Point(std::min(seed.x, image.cols - 1), std::min(seed.y, image.rows - 1));
+    }
+
+    // Refine at full resolution in the scaled-up bounding box, widened by how far downscaling and dilation can move an edge
+    int margin = factor + fullIterations;
+    cv::Rect window(box.x * factor - margin, box.y * factor - margin, box.width * factor + 2 * margin, box.height * factor + 2 * margin);
+    analyzeWindow(image, seed, window, analysis, buffers);
+}
+
+void ObjectDetection::setTrackingMargin(int margin) {
+    trackingMargin = std::max(margin, 0);
+}
+
+int ObjectDetection::getTrackingMargin() const {
+    return trackingMargin;
+}
+
+void ObjectDetection::resetTracking() {
+    track = Track();
+}
+
+TrackedObject ObjectDetection::trackCenterObject(const cv::Mat& image) {
+    TrackedObject result;
+    result.trackId = -1;
+    result.redetected = false;
+    result.record = FrameAnalysis().getRecord(-1, 0);
+
+    // Only the Canny pipeline can work on a region, see analyzeAround
+    bool local = track.active && segmentationMethod == SegmentationMethod::CannyContours;
+
+    cv::Point2f expected = track.centroid + track.velocity;
+    if (local) {
+        cv::Point shift(cvRound(track.velocity.x), cvRound(track.velocity.y));
+        cv::Rect expectedBox = track.box + shift;
+
+        // Widen by the margin plus the last motion, in case the object speeds up
+        int margin = trackingMargin + std::max(std::abs(shift.x), std::abs(shift.y));
+        result.searchRegion = cv::Rect(expectedBox.x - margin, expectedBox.y - margin, expectedBox.width + 2 * margin, expectedBox.height + 2 * margin)
+            & cv::Rect(0, 0, image.cols, image.rows);
+
+        int index = -1;
+        if (traceTrack(image, expected, expectedBox, result.searchRegion, scratch, index)) {
+            updateTrack(scratch.frame, index, true, result);
+            return result;
+        }
+    }
+
+    // Lost or not started: analyze the whole frame
+    result.redetected = true;
+    result.searchRegion = cv::Rect();
+    segment(image, scratch.frame, segmentationMethod, scratch);
+
+    int index = -1;
+    bool sameObject = false;
+    if (track.active) {
+        index = scratch.frame.getStats().findNearestCentroid(expected);
+        sameObject = index > -1 && cv::norm(scratch.frame.getCentroid(index) - expected) <= std::max(track.box.width, track.box.height);
+    }
+    if (!sameObject) {
+        index = scratch.frame.findCenterObject();
+    }
+
+    if (index < 0) {
+        track.active = false;
+        return result;
+    }
 
-            // Calculate the area
-            area = cv::contourArea(contour);
+    updateTrack(scratch.frame, index, sameObject, result);
+    return result;
+}
+
+bool ObjectDetection::traceTrack(const cv::Mat& image, cv::Point2f expected, const cv::Rect& expectedBox, cv::Rect region, Scratch& buffers, int& index) const {
+    cv::Rect imageRect(0, 0, image.cols, image.rows);
+
+    // Same iteration count as the full frame, so the region sees the same edge map
+    int dilateIterations = 2 + ((image.rows + image.cols) / 1500);
+    int margin = buffers.preprocessor.getBorderMargin(dilateIterations);
 
-            // Draw the contour containing the specific pixel
-            //drawWeightedContour(image, contour);
-            cv::drawContours(image, contour, -1, contourColor, 1 + ((image.rows + image.cols) / 400));
-            cv::circle(image, point, 5, cv::Scalar(0, 0, 255), -1); // Draw the specific pixel
+    while (true) {
+        region &= imageRect;
+        if (region.area() == 0) {
+            return false;
+        }
 
-            // Calculate center
-            center = cv::Point(0, 0);
-            for (const auto& p : contour) {
-                center += p;
+        cv::Rect padded = cv::Rect(region.x - margin, region.y - margin, region.width + 2 * margin, region.height + 2 * margin) & imageRect;
+        buffers.preprocessor.process(image(padded), buffers.dilatedEdges, dilateIterations);
+        cv::findContours(buffers.dilatedEdges(region - padded.tl()), buffers.rawContours, cv::RETR_EXTERNAL, cv::CHAIN_APPROX_SIMPLE, region.tl());
+        buffers.frame.assign(image.size(), buffers.rawContours, minArea, buffers.arena);
+
+        // The object overlapping the expected box whose centroid is closest to the expected one
+        const ContourStats& stats = buffers.frame.getStats();
+        index = -1;
+        double minDist = std::numeric_limits<double>::max();
+        for (size_t i = 0; i < stats.size(); i++) {
+            cv::Rect box(stats.boxX[i], stats.boxY[i], stats.boxWidth[i], stats.boxHeight[i]);
+            if ((box & expectedBox).area() == 0) {
+                continue;
             }
-            center.x /= contour.size();
-            center.y /= contour.size();
 
-            areaInfo = area;
-            imageInfo = image;
-            centerInfo = center;
+            double dist = cv::norm(cv::Point2f(stats.centroidX[i], stats.centroidY[i]) - expected);
+            if (dist < minDist) {
+                minDist = dist;
+                index = static_cast<int>(i);
+            }
+        }
+        if (index < 0) {
+            return false;
+        }
 
-            break;
+        // Grow the region while the object runs into a border that is not an image border
+        cv::Rect box = buffers.frame.getBoundingBox(index);
+        bool touchesBorder = (region.x > 0 && box.x <= region.x + 1)
+            || (region.y > 0 && box.y <= region.y + 1)
+            || (region.br().x < image.cols && box.br().x >= region.br().x - 1)
+            || (region.br().y < image.rows && box.br().y >= region.br().y - 1);
+        if (touchesBorder) {
+            region = cv::Rect(region.x - region.width / 2, region.y - region.height / 2, region.width * 2, region.height * 2);
+            continue;
         }
+
+        // An area changed by more than half either way means the prior latched onto something else
+        double area = stats.areas[index];
+        return std::abs(area - track.area) <= track.area / 2;
     }
 }
 
-void ObjectDetection::centerObjectInfo(cv::Mat image) {
+void ObjectDetection::updateTrack(const FrameAnalysis& analysis, int index, bool sameObject, TrackedObject& result) {
+    cv::Point2f centroid = analysis.getCentroid(index);
 
-    std::vector<std::vector<cv::Point>> contours = getContours(image);
-    double area = 0;
-    cv::Point center(0, 0);
+    if (sameObject) {
+        track.velocity = centroid - track.centroid;
+    }
+    else {
+        track.id = nextTrackId++;
+        track.velocity = cv::Point2f(0, 0);
+    }
+
+    track.active = true;
+    track.centroid = centroid;
+    track.box = analysis.getBoundingBox(index);
+    track.area = analysis.getArea(index);
+
+    result.trackId = track.id;
+    result.record = analysis.getRecord(index, 0);
+    result.contour = analysis.getContour(index);
+}
+
+FrameAnalysis ObjectDetection::detect(const cv::Mat& image) const {
+    FrameAnalysis analysis;
+    segment(image, analysis, segmentationMethod, getThreadScratch());
 
-    // Calculate centroids of contours
-    std::vector<cv::Moments> mu(contours.size());
-    for (size_t i = 0; i < contours.size(); i++) {
-        mu[i] = cv::moments(contours[i]);
+    return analysis;
+}
+
+ObjectRecord ObjectDetection::queryCenterObject(const cv::Mat& image, cv::Mat* output) const {
+    Scratch& buffers = getThreadScratch();
+    analyzeCenterQuery(image, buffers);
+
+    int index = buffers.frame.findCenterObject();
+    if (output) {
+        renderObject(image, buffers.frame, index, nullptr, *output);
     }
 
-    // Find the contour corresponding to the object in the center
-    cv::Point2f imageCenter(static_cast<float>(image.cols / 2), static_cast<float>(image.rows / 2));
-    int centerContourIndex = -1;
-    float minDist = std::numeric_limits<float>::max();
-
-    for (size_t i = 0; i < contours.size(); i++) {
-        cv::Point2f centroid(static_cast<float>(mu[i].m10 / mu[i].m00), static_cast<float>(mu[i].m01 / mu[i].m00));
-        float dist = cv::norm(imageCenter - centroid);
-
-        if (dist < minDist) {
-            minDist = dist;
-            centerContourIndex = static_cast<int>(i);
-            center.x = mu[i].m10 / mu[i].m00;
-            center.y = mu[i].m01 / mu[i].m00;
-            area = cv::contourArea(contours[i]);
+    return buffers.frame.getRecord(index, 0);
+}
+
+ObjectRecord ObjectDetection::queryObjectAt(const cv::Mat& image, cv::Point point, cv::Mat* output) const {
+    Scratch& buffers = getThreadScratch();
+    analyzePointQuery(image, point, buffers);
+
+    int index = buffers.frame.findObjectAt(point);
+    if (output) {
+        renderObject(image, buffers.frame, index, &point, *output);
+    }
+
+    return buffers.frame.getRecord(index, 0);
+}
+
+std::vector<PointQueryResult> ObjectDetection::queryObjects(const cv::Mat& image, const std::vector<cv::Point>& points) const {
+    Scratch& buffers = getThreadScratch();
+    segment(image, buffers.frame, segmentationMethod, buffers);
+
+    buffers.arena.prepare(buffers.labelMap, buffers.frame.getFrameSize(), CV_32SC1);
+    return buffers.frame.findObjectsAt(points, buffers.labelMap);
+}
+
+void ObjectDetection::renderObject(const cv::Mat& image, const FrameAnalysis& analysis, int index, const cv::Point* point, cv::Mat& output) const {
+    if (output.data != image.data) {
+        image.copyTo(output);
+    }
+
+    // Same outline as centerObjectInfo and findObjectInfo
+    if (index > -1) {
+        cv::drawContours(output, analysis.getContours(), index, contourColor, 1 + ((output.rows + output.cols) / 400));
+        if (point) {
+            cv::circle(output, *point, 5, cv::Scalar(0, 0, 255), -1);
         }
     }
+}
+
+void ObjectDetection::findObjectInfo(cv::Mat image, int x, int y) {
+    analyzePointQuery(image, cv::Point(x, y), scratch);
+    findObjectInfo(image, scratch.frame, x, y);
+}
+
+void ObjectDetection::findObjectInfo(cv::Mat image, const FrameAnalysis& analysis, int x, int y) {
+    imageInfo = image;
+
+    // Create a point for the specific pixel
+    cv::Point point(x, y);
+
+    // Check if the specific pixel is within any contour
+    int index = analysis.findObjectAt(point);
+    if (index > -1) {
+        // Draw the contour containing the specific pixel
+        //drawWeightedContour(image, analysis.getContours(), index);
+        cv::drawContours(image, analysis.getContours(), index, contourColor, 1 + ((image.rows + image.cols) / 400));
+        cv::circle(image, point, 5, cv::Scalar(0, 0, 255), -1); // Draw the specific pixel
+
+        // Centroid from the statistics table, the same center centerObjectInfo reports
+        cv::Moments mu = analysis.getMoments(index);
+        cv::Point center(static_cast<int>(mu.m10 / mu.m00), static_cast<int>(mu.m01 / mu.m00));
+
+        areaInfo = analysis.getArea(index);
+        imageInfo = image;
+        centerInfo = center;
+    }
+}
+
+void ObjectDetection::centerObjectInfo(cv::Mat image) {
+    analyzeCenterQuery(image, scratch);
+    centerObjectInfo(image, scratch.frame);
+}
+
+void ObjectDetection::centerObjectInfo(cv::Mat image, const FrameAnalysis& analysis) {
+    double area = 0;
+    cv::Point center(0, 0);
+
+    // Find the contour corresponding to the object in the center
+    int centerContourIndex = analysis.findCenterObject();
 
     // Draw the contour of the center object onto the image
     if (centerContourIndex > -1) {
-        //drawWeightedContour(image, contours[centerContourIndex]);
-        cv::drawContours(image, contours, centerContourIndex, contourColor, 1 + ((image.rows + image.cols) / 400));
+        cv::Moments mu = analysis.getMoments(centerContourIndex);
+        center.x = mu.m10 / mu.m00;
+        center.y = mu.m01 / mu.m00;
+        area = analysis.getArea(centerContourIndex);
+
+        //drawWeightedContour(image, analysis.getContours(), centerContourIndex);
+        cv::drawContours(image, analysis.getContours(), centerContourIndex, contourColor, 1 + ((image.rows + image.cols) / 400));
     }
 
     areaInfo = area;
@@ -161,140 +514,100 @@ void ObjectDetection::centerObjectInfo(cv::Mat image) {
 }
 
 cv::Mat ObjectDetection::findObject(cv::Mat image, int x, int y) {
+    analyze(image, scratch.frame);
+    return findObject(image, scratch.frame, x, y);
+}
+
+cv::Mat ObjectDetection::findObject(cv::Mat image, const FrameAnalysis& analysis, int x, int y) {
 
     // Create a point for the specific pixel
     cv::Point point(x, y);
 
-    std::vector<std::vector<cv::Point>> contours = getContours(image);
-
     // Check if the specific pixel is within any contour
-    for (const auto& contour : contours) {
-        if (cv::pointPolygonTest(contour, point, false) >= 0) {
-            // Draw the contour containing the specific pixel
-            //drawWeightedContour(image, contour);
-            cv::drawContours(image, contours, -1, contourColor, 1 + ((image.rows + image.cols) / 400));
-            cv::circle(image, point, 5, cv::Scalar(0, 0, 255), -1); // Draw the specific pixel
-            break;
-        }
+    if (analysis.findObjectAt(point) > -1) {
+        // Draw the contour containing the specific pixel
+        //drawWeightedContour(image, contour);
+        cv::drawContours(image, analysis.getContours(), -1, contourColor, 1 + ((image.rows + image.cols) / 400));
+        cv::circle(image, point, 5, cv::Scalar(0, 0, 255), -1); // Draw the specific pixel
     }
 
     return image;
 }
 
 int ObjectDetection::findObjectArea(cv::Mat image, int x, int y) {
-    // Create a point for the specific pixel
-    cv::Point point(x, y);
+    analyzePointQuery(image, cv::Point(x, y), scratch);
+    return findObjectArea(scratch.frame, x, y);
+}
 
-    std::vector<std::vector<cv::Point>> contours = getContours(image);
+int ObjectDetection::findObjectArea(const FrameAnalysis& analysis, int x, int y) {
     double area = 0;
 
-    // Check if the specific pixel is within any contour
-    for (const auto& contour : contours) {
-        if (cv::pointPolygonTest(contour, point, false) >= 0) {
-            //Find the area of the object
-            area = cv::contourArea(contour);
-
-            break;
-        }
+    // Find the area of the object containing the specific pixel
+    int index = analysis.findObjectAt(cv::Point(x, y));
+    if (index > -1) {
+        area = analysis.getArea(index);
     }
 
     return area;
 }
 
-int ObjectDetection::identifyCenterObjectArea(cv::Mat image) {
-
-    std::vector<std::vector<cv::Point>> contours = getContours(image);
+std::vector<PointQueryResult> ObjectDetection::findObjects(cv::Mat image, const std::vector<cv::Point>& points) {
+    analyze(image, scratch.frame);
+    return findObjects(scratch.frame, points);
+}
 
-    // Calculate centroids of contours
-    std::vector<cv::Moments> mu(contours.size());
-    for (size_t i = 0; i < contours.size(); i++) {
-        mu[i] = cv::moments(contours[i]);
-    }
+std::vector<PointQueryResult> ObjectDetection::findObjects(const FrameAnalysis& analysis, const std::vector<cv::Point>& points) {
+    scratch.arena.prepare(scratch.labelMap, analysis.getFrameSize(), CV_32SC1);
+    return analysis.findObjectsAt(points, scratch.labelMap);
+}
 
-    // Find the contour corresponding to the object in the center
-    cv::Point2f imageCenter(static_cast<float>(image.cols / 2), static_cast<float>(image.rows / 2));
-    int centerContourIndex = -1;
-    float minDist = std::numeric_limits<float>::max();
+int ObjectDetection::identifyCenterObjectArea(cv::Mat image) {
+    analyzeCenterQuery(image, scratch);
+    return identifyCenterObjectArea(scratch.frame);
+}
 
+int ObjectDetection::identifyCenterObjectArea(const FrameAnalysis& analysis) {
     double area = 0;
 
-    for (size_t i = 0; i < contours.size(); i++) {
-        cv::Point2f centroid(static_cast<float>(mu[i].m10 / mu[i].m00), static_cast<float>(mu[i].m01 / mu[i].m00));
-        float dist = cv::norm(imageCenter - centroid);
-
-        if (dist < minDist) {
-            minDist = dist;
-            area = cv::contourArea(contours[i]);
-        }
+    int centerContourIndex = analysis.findCenterObject();
+    if (centerContourIndex > -1) {
+        area = analysis.getArea(centerContourIndex);
     }
 
     return area;
 }
 
 cv::Mat ObjectDetection::identifyCenterObject(cv::Mat image) {
+    analyzeCenterQuery(image, scratch);
+    return identifyCenterObject(image, scratch.frame);
+}
 
-    std::vector<std::vector<cv::Point>> contours = getContours(image);
-
-    // Calculate centroids of contours
-    std::vector<cv::Moments> mu(contours.size());
-    for (size_t i = 0; i < contours.size(); i++) {
-        mu[i] = cv::moments(contours[i]);
-    }
-
-    // Find the contour corresponding to the object in the center
-    cv::Point2f imageCenter(static_cast<float>(image.cols / 2), static_cast<float>(image.rows / 2));
-    int centerContourIndex = -1;
-    float minDist = std::numeric_limits<float>::max();
-
-    double area = 0;
-
-    for (size_t i = 0; i < contours.size(); i++) {
-        cv::Point2f centroid(static_cast<float>(mu[i].m10 / mu[i].m00), static_cast<float>(mu[i].m01 / mu[i].m00));
-        float dist = cv::norm(imageCenter - centroid);
+cv::Mat ObjectDetection::identifyCenterObject(cv::Mat image, const FrameAnalysis& analysis) {
 
-        if (dist < minDist) {
-            minDist = dist;
-            centerContourIndex = i;
-        }
-    }
+    int centerContourIndex = analysis.findCenterObject();
 
     //Draw the contour of the center object onto the image
     if (centerContourIndex > -1){
-        drawWeightedContour(image, contours[centerContourIndex]);
+        drawWeightedContour(image, analysis.getContours(), centerContourIndex);
     }
 
     return image;
 }
 
 std::string ObjectDetection::findCenterOfObject(cv::Mat image) {
+    analyzeCenterQuery(image, scratch);
+    return findCenterOfObject(scratch.frame);
+}
 
-    std::vector<std::vector<cv::Point>> contours = getContours(image);
-
-    // Calculate centroids of contours
-    std::vector<cv::Moments> mu(contours.size());
-    for (size_t i = 0; i < contours.size(); i++) {
-        mu[i] = cv::moments(contours[i]);
-    }
+std::string ObjectDetection::findCenterOfObject(const FrameAnalysis& analysis) {
 
     // Find the contour corresponding to the object closest to the center
-    cv::Point2f imageCenter(static_cast<float>(image.cols / 2), static_cast<float>(image.rows / 2));
-    int centerContourIndex = -1;
-    float minDist = std::numeric_limits<float>::max();
-
-    for (size_t i = 0; i < contours.size(); i++) {
-        cv::Point2f centroid(static_cast<float>(mu[i].m10 / mu[i].m00), static_cast<float>(mu[i].m01 / mu[i].m00));
-        float dist = cv::norm(imageCenter - centroid);
-
-        if (dist < minDist) {
-            minDist = dist;
-            centerContourIndex = static_cast<int>(i);
-        }
-    }
+    int centerContourIndex = analysis.findCenterObject();
 
     // Return the centroid of the closest object
     cv::Point2f center;
     if (centerContourIndex != -1) {
-        center = cv::Point2f(mu[centerContourIndex].m10 / mu[centerContourIndex].m00, mu[centerContourIndex].m01 / mu[centerContourIndex].m00);
+        center = analysis.getCentroid(centerContourIndex);
     }
     else {
         center = cv::Point2f(-1, -1); // Return invalid point if no object found
@@ -3,34 +3,195 @@
 
 #include <opencv2/opencv.hpp>
 #include <iostream>
+#include "CannyContourBackend.hpp"
+#include "EdgePreprocessor.hpp"
+#include "FrameAnalysis.hpp"
+#include "OverlayRenderer.hpp"
+#include "ThresholdComponentsBackend.hpp"
 using namespace cv;
 
+// Built-in segmentation backends, see SegmentationBackend
+enum class SegmentationMethod {
+    // Canny edges, dilation and external contours (default)
+    CannyContours,
+    // Otsu threshold and connected components with statistics
+    ThresholdComponents
+};
+
+// Object followed from frame to frame by ObjectDetection::trackCenterObject
+struct TrackedObject {
+    // Stays the same while the object is followed, -1 when nothing was found
+    int trackId;
+    // True when this frame needed a full-frame detection instead of the search around the previous object
+    bool redetected;
+    // Region searched around the previous object, empty after a full-frame detection
+    cv::Rect searchRegion;
+    ObjectRecord record;
+    std::vector<cv::Point> contour;
+};
+
 class ObjectDetection {
 public:
+    // Runs the detection pipeline once; the result can be passed to any of the queries below
+    FrameAnalysis analyze(const cv::Mat& image);
+
+    // Same as above but refills an existing analysis, so repeated calls on frames of one size allocate nothing
+    void analyze(const cv::Mat& image, FrameAnalysis& analysis);
+
+    // Same as above with a specific segmentation method or backend for this call only
+    FrameAnalysis analyze(const cv::Mat& image, SegmentationMethod method);
+    void analyze(const cv::Mat& image, FrameAnalysis& analysis, SegmentationMethod method);
+    void analyze(const cv::Mat& image, FrameAnalysis& analysis, SegmentationBackend& backend);
+
+    // Coarse-to-fine mode for large images. Objects are first found on a copy downscaled by 2^levels, with
+    // dilation and minimum area scaled to match. Only the chosen object (closest to the center, or under
+    // the point) is then traced again at full resolution, starting from its scaled-up bounding box.
+    // The refined contour, area and centroid are those of the full-frame analysis; the approximation is in
+    // the choice: a close call for the center object can pick a neighbour, and an object that does not
+    // survive downscaling is reported as missing. The analysis holds the one refined object, or none.
+    void analyzeCenterPyramid(const cv::Mat& image, FrameAnalysis& analysis, int levels);
+    void analyzeAroundPyramid(const cv::Mat& image, cv::Point point, FrameAnalysis& analysis, int levels);
+
+    // Levels used by the center and point queries that take an image; 0 (the default) keeps them at full resolution
+    void setPyramidLevels(int levels);
+    int getPyramidLevels() const;
+
+    // Tracking mode for streams of near-identical frames. The first call runs the center query on the
+    // whole frame. Later calls only preprocess a region around the previous object's bounding box,
+    // moved by its last motion and widened by the tracking margin, and grow it while the object touches
+    // its border, like analyzeAround. When the object is not found there, or its area grew or shrank by
+    // more than half, the whole frame is analyzed again: an object close to where the track was expected
+    // keeps the track id, otherwise the center object starts a new track.
+    TrackedObject trackCenterObject(const cv::Mat& image);
+    void resetTracking();
+
+    void setTrackingMargin(int margin);
+    int getTrackingMargin() const;
+
+    // Method used by analyze and by every query that takes an image
+    void setSegmentationMethod(SegmentationMethod method);
+    SegmentationMethod getSegmentationMethod() const;
+
+    // Finds only the object containing point, starting from a small window around it and growing the
+    // window while that object's contour touches the window border. The analysis holds that one object
+    // (or none) with the same contour and area the full-frame analyze would give, unless its outline is
+    // enclosed by a larger one or relies on a weak Canny edge chain that both leave the final window.
+    // Points inside an object cost time in proportion to the object; points on the background grow to the full frame.
+    // Only the Canny method is local; with other methods the full frame is analyzed.
+    // Opt-in only: the point queries that take an image analyze the full frame unless pyramid levels are set.
+    FrameAnalysis analyzeAround(const cv::Mat& image, cv::Point point);
+    void analyzeAround(const cv::Mat& image, cv::Point point, FrameAnalysis& analysis);
+
     cv::Mat identifyCenterObject(cv::Mat image);
+    cv::Mat identifyCenterObject(cv::Mat image, const FrameAnalysis& analysis);
     int identifyCenterObjectArea(cv::Mat image);
+    int identifyCenterObjectArea(const FrameAnalysis& analysis);
     std::string findCenterOfObject(cv::Mat image);
+    std::string findCenterOfObject(const FrameAnalysis& analysis);
 
     cv::Mat findObject(cv::Mat image, int x, int y);
+    cv::Mat findObject(cv::Mat image, const FrameAnalysis& analysis, int x, int y);
     int findObjectArea(cv::Mat image, int x, int y);
+    int findObjectArea(const FrameAnalysis& analysis, int x, int y);
+
+    // Object id, area and centroid for every point, resolved through one label map
+    std::vector<PointQueryResult> findObjects(cv::Mat image, const std::vector<cv::Point>& points);
+    std::vector<PointQueryResult> findObjects(const FrameAnalysis& analysis, const std::vector<cv::Point>& points);
 
     cv::Mat getEdges(cv::Mat image);
 
+    // Reentrant queries: const, read the image without touching it and return results by value, so one
+    // instance can serve any number of threads as long as its settings are not changed meanwhile.
+    // Scratch buffers are kept per thread instead of per instance. When output is given, it receives
+    // a copy of the image with the object outlined; pass the image itself to draw in place.
+    // The record's objectId is the index in the analysis made for that call.
+    FrameAnalysis detect(const cv::Mat& image) const;
+    ObjectRecord queryCenterObject(const cv::Mat& image, cv::Mat* output = nullptr) const;
+    ObjectRecord queryObjectAt(const cv::Mat& image, cv::Point point, cv::Mat* output = nullptr) const;
+    std::vector<PointQueryResult> queryObjects(const cv::Mat& image, const std::vector<cv::Point>& points) const;
+
     double getArea();
     cv::Mat getImage();
     cv::Point getCenter();
 
+    // Number of times the scratch buffers owned by this instance had to allocate memory
+    size_t getAllocationCount() const;
+
+    // Draw into image, whose pixels are shared with the caller's Mat, and keep the result for
+    // getArea, getImage and getCenter. Not safe to call on one instance from several threads.
     void findObjectInfo(cv::Mat image, int x, int y);
+    void findObjectInfo(cv::Mat image, const FrameAnalysis& analysis, int x, int y);
     void centerObjectInfo(cv::Mat image);
+    void centerObjectInfo(cv::Mat image, const FrameAnalysis& analysis);
 
 private:
-    double areaInfo;
+    double areaInfo = 0;
     cv::Mat imageInfo;
     cv::Point centerInfo;
 
     cv::Scalar contourColor = cv::Scalar(222, 181, 255);
-    void drawWeightedContour(cv::Mat image, std::vector<cv::Point> contour);
-    std::vector<std::vector<cv::Point>> getContours(cv::Mat& image);
+    int minArea = 2000;
+    SegmentationMethod segmentationMethod = SegmentationMethod::CannyContours;
+    int pyramidLevels = 0;
+
+    // Side length of the first window analyzeAround looks at
+    int queryWindowSize = 256;
+
+    // Object followed by trackCenterObject
+    struct Track {
+        bool active = false;
+        int id = -1;
+        cv::Rect box;
+        cv::Point2f centroid;
+        cv::Point2f velocity;
+        double area = 0;
+    };
+
+    Track track;
+    int nextTrackId = 0;
+    int trackingMargin = 32;
+
+    // Scratch buffers reused from call to call
+    struct Scratch {
+        ScratchArena arena;
+        CannyContourBackend cannyContours;
+        ThresholdComponentsBackend thresholdComponents;
+        EdgePreprocessor preprocessor;
+        cv::Mat dilatedEdges;
+        std::vector<std::vector<cv::Point>> rawContours;
+        FrameAnalysis frame;
+        FrameAnalysis coarse;
+        cv::Mat pyramidImage;
+        cv::Mat labelMap;
+        cv::Mat seedMask;
+        cv::Mat seedDistance;
+    };
+
+    // Used by the non-const methods; the const ones use getThreadScratch
+    Scratch scratch;
+    OverlayRenderer overlay;
+
+    static Scratch& getThreadScratch();
+
+    void segment(const cv::Mat& image, FrameAnalysis& analysis, SegmentationMethod method, Scratch& buffers) const;
+
+    // Fill buffers.frame for the image overloads, honouring the pyramid setting
+    void analyzeCenterQuery(const cv::Mat& image, Scratch& buffers) const;
+    void analyzePointQuery(const cv::Mat& image, cv::Point point, Scratch& buffers) const;
+
+    // Traces the object containing point, starting from window and doubling it while the contour touches its border
+    void analyzeWindow(const cv::Mat& image, cv::Point point, cv::Rect window, FrameAnalysis& analysis, Scratch& buffers) const;
+    void traceAround(const cv::Mat& image, cv::Point point, FrameAnalysis& analysis, Scratch& buffers) const;
+    void analyzePyramid(const cv::Mat& image, bool centerQuery, cv::Point point, FrameAnalysis& analysis, int levels, Scratch& buffers) const;
+
+    // Finds the object of the track in region, filling buffers.frame; false when the track is lost there
+    bool traceTrack(const cv::Mat& image, cv::Point2f expected, const cv::Rect& expectedBox, cv::Rect region, Scratch& buffers, int& index) const;
+    void updateTrack(const FrameAnalysis& analysis, int index, bool sameObject, TrackedObject& result);
+
+    // Copies image into output unless they share pixels, then outlines the object and marks point if given
+    void renderObject(const cv::Mat& image, const FrameAnalysis& analysis, int index, const cv::Point* point, cv::Mat& output) const;
+
+    void drawWeightedContour(cv::Mat image, const std::vector<std::vector<cv::Point>>& contours, int index);
 };
 
 #endif // OBJECTDETECTION_HPP
\ No newline at end of file
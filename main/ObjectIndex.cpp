@@ -0,0 +1,216 @@
+#include "ObjectIndex.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+ObjectIndex::ObjectIndex() : frameSize(0, 0) {
+}
+
+ObjectIndex::ObjectIndex(const FrameAnalysis& analysis) : frameSize(0, 0) {
+    build(analysis);
+}
+
+size_t ObjectIndex::size() const {
+    return objects.size();
+}
+
+bool ObjectIndex::empty() const {
+    return objects.empty();
+}
+
+bool ObjectIndex::Candidate::operator<(const Candidate& other) const {
+    // Equal distances go to the lower index, like the linear scan
+    return distance < other.distance || (distance == other.distance && object < other.object);
+}
+
+float ObjectIndex::getDistance(cv::Point2f point, float x, float y) {
+    // Same rounding as cv::norm on the float difference
+    float dx = point.x - x;
+    float dy = point.y - y;
+    return static_cast<float>(std::sqrt(static_cast<double>(dx) * dx + static_cast<double>(dy) * dy));
+}
+
+void ObjectIndex::build(const FrameAnalysis& analysis) {
+    frameSize = analysis.getFrameSize();
+
+    const ContourStats& stats = analysis.getStats();
+    size_t count = stats.size();
+
+    objects.resize(count);
+    pointX.resize(count);
+    pointY.resize(count);
+    axes.resize(count);
+    bounds.resize(count);
+    boxes.resize(count);
+
+    for (size_t i = 0; i < count; i++) {
+        objects[i] = static_cast<int>(i);
+    }
+    buildRange(stats, 0, static_cast<int>(count));
+
+    // Copy each object's values next to its node
+    for (size_t i = 0; i < count; i++) {
+        int object = objects[i];
+        pointX[i] = stats.centroidX[object];
+        pointY[i] = stats.centroidY[object];
+        boxes[i] = cv::Rect(stats.boxX[object], stats.boxY[object], stats.boxWidth[object], stats.boxHeight[object]);
+    }
+
+    if (count > 0) {
+        buildBounds(0, static_cast<int>(count));
+    }
+}
+
+void ObjectIndex::buildRange(const ContourStats& stats, int begin, int end) {
+    while (end - begin > 1) {
+        float minX = std::numeric_limits<float>::max();
+        float minY = std::numeric_limits<float>::max();
+        float maxX = -std::numeric_limits<float>::max();
+        float maxY = -std::numeric_limits<float>::max();
+        for (int i = begin; i < end; i++) {
+            minX = std::min(minX, stats.centroidX[objects[i]]);
+            maxX = std::max(maxX, stats.centroidX[objects[i]]);
+            minY = std::min(minY, stats.centroidY[objects[i]]);
+            maxY = std::max(maxY, stats.centroidY[objects[i]]);
+        }
+
+        // Split along the wider spread at the median
+        unsigned char axis = (maxX - minX) >= (maxY - minY) ? 0 : 1;
+        const std::vector<float>& coordinates = axis == 0 ? stats.centroidX : stats.centroidY;
+
+        int middle = (begin + end) / 2;
+        std::nth_element(objects.begin() + begin, objects.begin() + middle, objects.begin() + end,
+            [&](int a, int b) { return coordinates[a] < coordinates[b]; });
+        axes[middle] = axis;
+
+        buildRange(stats, begin, middle);
+        begin = middle + 1;
+    }
+
+    if (begin < end) {
+        axes[begin] = 0;
+    }
+}
+
+cv::Rect ObjectIndex::buildBounds(int begin, int end) {
+    int middle = (begin + end) / 2;
+
+    cv::Rect box = boxes[middle];
+    if (begin < middle) {
+        box |= buildBounds(begin, middle);
+    }
+    if (middle + 1 < end) {
+        box |= buildBounds(middle + 1, end);
+    }
+    bounds[middle] = box;
+
+    return box;
+}
+
+int ObjectIndex::findNearest(cv::Point2f point) const {
+    std::vector<int> nearest;
+    findNearest(point, 1, nearest);
+
+    return nearest.empty() ? -1 : nearest[0];
+}
+
+std::vector<int> ObjectIndex::findNearest(cv::Point2f point, int k) const {
+    std::vector<int> nearest;
+    findNearest(point, k, nearest);
+
+    return nearest;
+}
+
+void ObjectIndex::findNearest(cv::Point2f point, int k, std::vector<int>& result) const {
+    result.clear();
+    if (k <= 0 || objects.empty()) {
+        return;
+    }
+
+    std::vector<Candidate> heap;
+    heap.reserve(std::min(static_cast<size_t>(k), objects.size()) + 1);
+    searchNearest(0, static_cast<int>(objects.size()), point, static_cast<size_t>(k), heap);
+
+    std::sort_heap(heap.begin(), heap.end());
+    for (const Candidate& candidate : heap) {
+        result.push_back(candidate.object);
+    }
+}
+
+void ObjectIndex::searchNearest(int begin, int end, cv::Point2f point, size_t k, std::vector<Candidate>& heap) const {
+    if (begin >= end) {
+        return;
+    }
+
+    int middle = (begin + end) / 2;
+
+    Candidate candidate = { getDistance(point, pointX[middle], pointY[middle]), objects[middle] };
+    if (heap.size() < k) {
+        heap.push_back(candidate);
+        std::push_heap(heap.begin(), heap.end());
+    }
+    else if (candidate < heap.front()) {
+        std::pop_heap(heap.begin(), heap.end());
+        heap.back() = candidate;
+        std::push_heap(heap.begin(), heap.end());
+    }
+
+    // Visit the side of the split holding the point first
+    float split = axes[middle] == 0 ? pointX[middle] : pointY[middle];
+    float coordinate = axes[middle] == 0 ? point.x : point.y;
+    float planeDistance = std::fabs(coordinate - split);
+    bool lowFirst = coordinate < split;
+
+    if (lowFirst) {
+        searchNearest(begin, middle, point, k, heap);
+    }
+    else {
+        searchNearest(middle + 1, end, point, k, heap);
+    }
+
+    // Every object beyond the plane is at least planeDistance away; equal distances are still
+    // visited so a lower index can win the tie
+    if (heap.size() < k || planeDistance <= heap.front().distance) {
+        if (lowFirst) {
+            searchNearest(middle + 1, end, point, k, heap);
+        }
+        else {
+            searchNearest(begin, middle, point, k, heap);
+        }
+    }
+}
+
+std::vector<int> ObjectIndex::findOverlapping(const cv::Rect& rect) const {
+    std::vector<int> result;
+    findOverlapping(rect, result);
+
+    return result;
+}
+
+void ObjectIndex::findOverlapping(const cv::Rect& rect, std::vector<int>& result) const {
+    result.clear();
+    searchOverlapping(0, static_cast<int>(objects.size()), rect, result);
+    std::sort(result.begin(), result.end());
+}
+
+void ObjectIndex::searchOverlapping(int begin, int end, const cv::Rect& rect, std::vector<int>& result) const {
+    if (begin >= end) {
+        return;
+    }
+
+    int middle = (begin + end) / 2;
+    if ((bounds[middle] & rect).area() == 0) {
+        return;
+    }
+
+    if ((boxes[middle] & rect).area() > 0) {
+        result.push_back(objects[middle]);
+    }
+
+    searchOverlapping(begin, middle, rect, result);
+    searchOverlapping(middle + 1, end, rect, result);
+}
+
+int ObjectIndex::findCenterObject() const {
+    return findNearest(cv::Point2f(static_cast<float>(frameSize.width / 2), static_cast<float>(frameSize.height / 2)));
+}
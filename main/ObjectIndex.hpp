@@ -0,0 +1,66 @@
+#ifndef OBJECTINDEX_HPP
+#define OBJECTINDEX_HPP
+
+#include <opencv2/opencv.hpp>
+#include <vector>
+#include "FrameAnalysis.hpp"
+using namespace cv;
+
+// KD-tree over the objects of one FrameAnalysis, for answering many nearest-object and
+// rectangle queries per frame in logarithmic time instead of scanning every object.
+// Nodes split on object centroids and also keep the union of the bounding boxes below them,
+// so the same tree answers rectangle-overlap queries. Build once per analyzed frame; rebuilding
+// reuses the memory. Distances and ties are resolved like FrameAnalysis::findCenterObject,
+// so findCenterObject gives the same index.
+class ObjectIndex {
+public:
+    ObjectIndex();
+    explicit ObjectIndex(const FrameAnalysis& analysis);
+
+    void build(const FrameAnalysis& analysis);
+
+    size_t size() const;
+    bool empty() const;
+
+    // Object whose centroid is closest to point, -1 if there are none
+    int findNearest(cv::Point2f point) const;
+
+    // Up to k objects closest to point, nearest first
+    std::vector<int> findNearest(cv::Point2f point, int k) const;
+    void findNearest(cv::Point2f point, int k, std::vector<int>& objects) const;
+
+    // Objects whose bounding box shares at least one pixel with rect, in ascending index order
+    std::vector<int> findOverlapping(const cv::Rect& rect) const;
+    void findOverlapping(const cv::Rect& rect, std::vector<int>& objects) const;
+
+    // Nearest object to the center of the analyzed frame
+    int findCenterObject() const;
+
+private:
+    cv::Size frameSize;
+
+    // Objects in tree order: the node of range [begin, end) is at (begin + end) / 2.
+    // Per node the object index, its centroid, the split axis and the union of the boxes in its range.
+    std::vector<int> objects;
+    std::vector<float> pointX;
+    std::vector<float> pointY;
+    std::vector<unsigned char> axes;
+    std::vector<cv::Rect> bounds;
+    std::vector<cv::Rect> boxes;
+
+    // (distance, object) pairs of the k-nearest search, kept as a max-heap
+    struct Candidate {
+        float distance;
+        int object;
+        bool operator<(const Candidate& other) const;
+    };
+
+    // Orders objects[begin, end) into a balanced tree by centroid
+    void buildRange(const ContourStats& stats, int begin, int end);
+    cv::Rect buildBounds(int begin, int end);
+    void searchNearest(int begin, int end, cv::Point2f point, size_t k, std::vector<Candidate>& heap) const;
+    void searchOverlapping(int begin, int end, const cv::Rect& rect, std::vector<int>& result) const;
+    static float getDistance(cv::Point2f point, float x, float y);
+};
+
+#endif // OBJECTINDEX_HPP
@@ -0,0 +1,66 @@
+#include "OverlayRenderer.hpp"
+#include "Tracing.hpp"
+#include <climits>
+
+size_t OverlayRenderer::getAllocationCount() const {
+    return arena.getAllocationCount();
+}
+
+void OverlayRenderer::draw(cv::Mat image, const std::vector<std::vector<cv::Point>>& contours, int index) {
+    if (index > -1) {
+        arena.resize(allIndices, 1);
+        allIndices[0] = index;
+    }
+    else {
+        arena.resize(allIndices, contours.size());
+        for (size_t i = 0; i < contours.size(); i++) {
+            allIndices[i] = static_cast<int>(i);
+        }
+    }
+
+    draw(image, contours, allIndices);
+}
+
+void OverlayRenderer::draw(cv::Mat image, const std::vector<std::vector<cv::Point>>& contours, const std::vector<int>& indices) {
+    TRACE_SCOPE("overlay");
+    cv::Rect imageRect(0, 0, image.cols, image.rows);
+
+    // Size the shared buffers once for the largest bounding box of this call
+    arena.resize(boxes, indices.size());
+    cv::Size largest(0, 0);
+    for (size_t i = 0; i < indices.size(); i++) {
+        boxes[i] = cv::boundingRect(contours[indices[i]]) & imageRect;
+        largest.width = std::max(largest.width, boxes[i].width);
+        largest.height = std::max(largest.height, boxes[i].height);
+    }
+
+    if (largest.area() == 0) {
+        return;
+    }
+
+    arena.prepare(maskBuffer, cv::Size(std::max(largest.width, maskBuffer.cols), std::max(largest.height, maskBuffer.rows)), CV_8UC1);
+    arena.prepare(overlayBuffer, maskBuffer.size(), image.type());
+
+    int thickness = 1 + ((image.rows + image.cols) / 400);
+    for (size_t i = 0; i < indices.size(); i++) {
+        const cv::Rect& box = boxes[i];
+        if (box.area() == 0) {
+            continue;
+        }
+
+        // Fill the contour into the top-left corner of the mask, shifted into box coordinates
+        cv::Rect local(0, 0, box.width, box.height);
+        cv::Mat mask = maskBuffer(local);
+        mask.setTo(cv::Scalar(0));
+        cv::drawContours(mask, contours, indices[i], cv::Scalar(255), cv::FILLED, cv::LINE_8, cv::noArray(), INT_MAX, -box.tl());
+
+        // Outside the mask the overlay equals the image, so blending only the box leaves the rest unchanged
+        cv::Mat region = image(box);
+        cv::Mat overlay = overlayBuffer(local);
+        region.copyTo(overlay);
+        overlay.setTo(color, mask);
+        cv::addWeighted(overlay, alpha, region, 1.0 - alpha, 0, region);
+
+        cv::drawContours(image, contours, indices[i], color, thickness);
+    }
+}
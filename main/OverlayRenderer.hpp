@@ -0,0 +1,35 @@
+#ifndef OVERLAYRENDERER_HPP
+#define OVERLAYRENDERER_HPP
+
+#include <opencv2/opencv.hpp>
+#include <vector>
+#include "ScratchArena.hpp"
+using namespace cv;
+
+// Translucent contour highlighting that only touches the pixels inside each contour's bounding box.
+// Gives the same image as filling a full-frame mask, blending the whole frame with addWeighted and
+// drawing the outline, once per contour in turn. The mask and overlay buffers are shared by all
+// contours of a call and kept between calls, sized to the largest bounding box.
+class OverlayRenderer {
+public:
+    // Highlights contours[index], or all contours when index is -1
+    void draw(cv::Mat image, const std::vector<std::vector<cv::Point>>& contours, int index);
+
+    // Highlights every contour listed in indices, in that order
+    void draw(cv::Mat image, const std::vector<std::vector<cv::Point>>& contours, const std::vector<int>& indices);
+
+    // Buffers (re)allocated by draw, see ScratchArena
+    size_t getAllocationCount() const;
+
+    cv::Scalar color = cv::Scalar(222, 181, 255);
+    double alpha = 0.4;
+
+private:
+    ScratchArena arena;
+    cv::Mat maskBuffer;
+    cv::Mat overlayBuffer;
+    std::vector<int> allIndices;
+    std::vector<cv::Rect> boxes;
+};
+
+#endif // OVERLAYRENDERER_HPP
@@ -0,0 +1,146 @@
+#include "ResultWriter.hpp"
+#include <cstdio>
+#include <algorithm>
+#include <cstring>
+
+namespace {
+    // Longest formatted JSON object line, path excluded
+    const size_t maxRecordText = 256;
+
+    const uint8_t imageRecordType = 1;
+    const uint8_t objectRecordType = 2;
+}
+
+ResultWriter::ResultWriter(std::ostream& output, ResultFormat format, size_t bufferBytes)
+    : output(output), format(format), buffer(std::max(bufferBytes, maxRecordText)) {
+}
+
+ResultWriter::~ResultWriter() {
+    flush();
+}
+
+size_t ResultWriter::getRecordCount() const {
+    return recordCount;
+}
+
+void ResultWriter::flush() {
+    if (used > 0) {
+        output.write(buffer.data(), static_cast<std::streamsize>(used));
+        used = 0;
+    }
+    output.flush();
+}
+
+char* ResultWriter::reserve(size_t bytes) {
+    if (used + bytes > buffer.size()) {
+        output.write(buffer.data(), static_cast<std::streamsize>(used));
+        used = 0;
+    }
+    return buffer.data() + used;
+}
+
+void ResultWriter::append(const void* data, size_t bytes) {
+    // Larger than the whole buffer, e.g. a very long path: write it through
+    if (bytes > buffer.size()) {
+        reserve(buffer.size());
+        output.write(static_cast<const char*>(data), static_cast<std::streamsize>(bytes));
+        return;
+    }
+
+    std::memcpy(reserve(bytes), data, bytes);
+    used += bytes;
+}
+
+void ResultWriter::appendText(const char* text) {
+    append(text, std::strlen(text));
+}
+
+void ResultWriter::appendJsonString(const std::string& text) {
+    appendText("\"");
+
+    size_t start = 0;
+    for (size_t i = 0; i < text.size(); i++) {
+        unsigned char c = static_cast<unsigned char>(text[i]);
+        if (c != '"' && c != '\\' && c >= 0x20) {
+            continue;
+        }
+
+        // Copy the plain run, then the escaped character
+        append(text.data() + start, i - start);
+        start = i + 1;
+
+        char escaped[8];
+        if (c == '"' || c == '\\') {
+            escaped[0] = '\\';
+            escaped[1] = static_cast<char>(c);
+            escaped[2] = '\0';
+        }
+        else {
+            std::snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+        }
+        appendText(escaped);
+    }
+    append(text.data() + start, text.size() - start);
+
+    appendText("\"");
+}
+
+void ResultWriter::writeImage(uint32_t imageId, const std::string& path, bool ok, int objectCount) {
+    recordCount++;
+
+    if (format == ResultFormat::Binary) {
+        uint32_t pathLength = static_cast<uint32_t>(path.size());
+        uint32_t length = static_cast<uint32_t>(sizeof(uint8_t) + sizeof(uint32_t) + sizeof(uint8_t) + 2 * sizeof(uint32_t) + path.size());
+
+        appendValue(length);
+        appendValue(imageRecordType);
+        appendValue(imageId);
+        appendValue(static_cast<uint8_t>(ok ? 1 : 0));
+        appendValue(static_cast<uint32_t>(objectCount));
+        appendValue(pathLength);
+        append(path.data(), path.size());
+        return;
+    }
+
+    char* text = reserve(maxRecordText);
+    used += std::snprintf(text, maxRecordText, "{\"image\":%u,\"path\":", imageId);
+    appendJsonString(path);
+
+    text = reserve(maxRecordText);
+    used += std::snprintf(text, maxRecordText, ",\"ok\":%s,\"objects\":%d}\n", ok ? "true" : "false", objectCount);
+}
+
+void ResultWriter::writeObject(const ObjectRecord& record) {
+    recordCount++;
+
+    if (format == ResultFormat::Binary) {
+        // Field by field, so the layout does not depend on the compiler's struct padding
+        uint32_t length = static_cast<uint32_t>(sizeof(uint8_t) + 3 * sizeof(uint32_t) + sizeof(double) + 2 * sizeof(float) + 4 * sizeof(int32_t));
+
+        appendValue(length);
+        appendValue(objectRecordType);
+        appendValue(record.imageId);
+        appendValue(record.objectId);
+        appendValue(record.area);
+        appendValue(record.centroidX);
+        appendValue(record.centroidY);
+        appendValue(record.boxX);
+        appendValue(record.boxY);
+        appendValue(record.boxWidth);
+        appendValue(record.boxHeight);
+        appendValue(record.contourPoints);
+        return;
+    }
+
+    char* text = reserve(maxRecordText);
+    used += std::snprintf(text, maxRecordText,
+        "{\"image\":%u,\"object\":%d,\"area\":%.17g,\"centroid\":[%.9g,%.9g],\"box\":[%d,%d,%d,%d],\"points\":%u}\n",
+        record.imageId, record.objectId, record.area, record.centroidX, record.centroidY,
+        record.boxX, record.boxY, record.boxWidth, record.boxHeight, record.contourPoints);
+}
+
+void ResultWriter::writeObjects(const FrameAnalysis& analysis, uint32_t imageId) {
+    for (int i = 0; i < analysis.getObjectCount(); i++) {
+        writeObject(analysis.getRecord(i, imageId));
+    }
+}
@@ -0,0 +1,67 @@
+#ifndef RESULTWRITER_HPP
+#define RESULTWRITER_HPP
+
+#include <opencv2/opencv.hpp>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "FrameAnalysis.hpp"
+using namespace cv;
+
+enum class ResultFormat {
+    // One JSON object per line
+    JsonLines,
+    // Length-prefixed records in native byte order, see ResultWriter
+    Binary
+};
+
+// Streams image and object results to a file or stream through one fixed buffer, formatting each record
+// in place so writing allocates nothing per record. Not thread-safe; use it from a single writer thread.
+//
+// JSON lines:
+//   {"image":0,"path":"a.jpg","ok":true,"objects":12}
+//   {"image":0,"object":3,"area":2510,"centroid":[320.5,240.25],"box":[290,210,61,60],"points":48}
+//
+// Binary: every record is a uint32 length of the bytes that follow, then a uint8 type.
+//   type 1 (image):  uint32 imageId, uint8 ok, uint32 objectCount, uint32 pathLength, path bytes
+//   type 2 (object): uint32 imageId, int32 objectId, float64 area, float32 centroidX, float32 centroidY,
+//                    int32 boxX, int32 boxY, int32 boxWidth, int32 boxHeight, uint32 contourPoints
+class ResultWriter {
+public:
+    ResultWriter(std::ostream& output, ResultFormat format, size_t bufferBytes = 1 << 20);
+    ~ResultWriter();
+
+    // One line or record per image, written before its objects
+    void writeImage(uint32_t imageId, const std::string& path, bool ok, int objectCount);
+    void writeObject(const ObjectRecord& record);
+
+    // Every object of an analysis, as records of imageId
+    void writeObjects(const FrameAnalysis& analysis, uint32_t imageId);
+
+    // Hands the buffered bytes to the stream and flushes it
+    void flush();
+
+    // Records written so far
+    size_t getRecordCount() const;
+
+private:
+    std::ostream& output;
+    ResultFormat format;
+    std::vector<char> buffer;
+    size_t used = 0;
+    size_t recordCount = 0;
+
+    // Space for at least bytes more, draining the buffer to the stream if needed
+    char* reserve(size_t bytes);
+    void append(const void* data, size_t bytes);
+    void appendText(const char* text);
+    void appendJsonString(const std::string& text);
+
+    template <typename T>
+    void appendValue(T value) {
+        append(&value, sizeof(value));
+    }
+};
+
+#endif // RESULTWRITER_HPP
@@ -0,0 +1,15 @@
+#include "ScratchArena.hpp"
+
+void ScratchArena::prepare(cv::Mat& buffer, cv::Size size, int type) {
+    // create() is a no-op when size and type already match, so a moved data pointer means new memory
+    const uchar* before = buffer.data;
+    buffer.create(size, type);
+
+    if (buffer.data != before) {
+        allocations++;
+    }
+}
+
+size_t ScratchArena::getAllocationCount() const {
+    return allocations;
+}
@@ -0,0 +1,32 @@
+#ifndef SCRATCHARENA_HPP
+#define SCRATCHARENA_HPP
+
+#include <opencv2/opencv.hpp>
+#include <vector>
+using namespace cv;
+
+// Keeps track of the scratch buffers an object reuses between calls.
+// Buffers only get new memory when they have to change size or grow, and every
+// such allocation is counted so steady-state code can check it allocates nothing.
+// Temporaries allocated inside OpenCV functions are not visible here.
+class ScratchArena {
+public:
+    // Gives buffer the requested size and type, keeping its memory when it already matches
+    void prepare(cv::Mat& buffer, cv::Size size, int type);
+
+    // Resizes the vector, counting an allocation when its capacity has to grow
+    template<typename T>
+    void resize(std::vector<T>& buffer, size_t size) {
+        if (size > buffer.capacity()) {
+            allocations++;
+        }
+        buffer.resize(size);
+    }
+
+    size_t getAllocationCount() const;
+
+private:
+    size_t allocations = 0;
+};
+
+#endif // SCRATCHARENA_HPP
\ No newline at end of file
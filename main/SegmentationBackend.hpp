@@ -0,0 +1,24 @@
+#ifndef SEGMENTATIONBACKEND_HPP
+#define SEGMENTATIONBACKEND_HPP
+
+#include <opencv2/opencv.hpp>
+#include "FrameAnalysis.hpp"
+using namespace cv;
+
+// A way of turning an image into objects. ObjectDetection runs one of these for every analysis,
+// see ObjectDetection::analyze.
+class SegmentationBackend {
+public:
+    virtual ~SegmentationBackend() {
+    }
+
+    // Fills analysis with the objects of image whose area is at least minArea
+    virtual void segment(const cv::Mat& image, double minArea, FrameAnalysis& analysis) = 0;
+
+    virtual const char* getName() const = 0;
+
+    // Number of times the backend's own buffers had to allocate memory
+    virtual size_t getAllocationCount() const = 0;
+};
+
+#endif // SEGMENTATIONBACKEND_HPP
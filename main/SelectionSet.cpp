@@ -0,0 +1,245 @@
+#include "SelectionSet.hpp"
+#include <algorithm>
+
+SelectionSet::SelectionSet(int cellSize) : cellSize(std::max(cellSize, 1)) {
+}
+
+long long SelectionSet::getCellKey(int cellX, int cellY) const {
+    return (static_cast<long long>(cellY) << 32) | static_cast<unsigned>(cellX);
+}
+
+std::vector<int> SelectionSet::findCandidates(const cv::Rect& box) const {
+    std::vector<int> candidates;
+
+    // Entries spanning several cells are listed in each, so skip the ones already seen
+    visitStamp++;
+    visited.resize(entries.size(), 0);
+
+    for (int cellY = box.y / cellSize; cellY <= (box.y + box.height - 1) / cellSize; cellY++) {
+        for (int cellX = box.x / cellSize; cellX <= (box.x + box.width - 1) / cellSize; cellX++) {
+            auto cell = grid.find(getCellKey(cellX, cellY));
+            if (cell == grid.end()) {
+                continue;
+            }
+
+            for (int id : cell->second) {
+                if (visited[id] != visitStamp) {
+                    visited[id] = visitStamp;
+                    candidates.push_back(id);
+                }
+            }
+        }
+    }
+
+    return candidates;
+}
+
+bool SelectionSet::encloses(const Entry& outer, const std::vector<cv::Point>& inner, const cv::Rect& innerBox) const {
+    if ((outer.boundingBox & innerBox) != innerBox) {
+        return false;
+    }
+
+    // Contours from one detection never cross, so a few points spread along the inner contour are enough
+    size_t step = std::max<size_t>(inner.size() / 16, 1);
+    for (size_t i = 0; i < inner.size(); i += step) {
+        if (cv::pointPolygonTest(outer.contour, inner[i], false) < 0) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void SelectionSet::select(int id) {
+    Entry& entry = entries[id];
+    entry.selected = true;
+
+    const cv::Rect& box = entry.boundingBox;
+    for (int cellY = box.y / cellSize; cellY <= (box.y + box.height - 1) / cellSize; cellY++) {
+        for (int cellX = box.x / cellSize; cellX <= (box.x + box.width - 1) / cellSize; cellX++) {
+            grid[getCellKey(cellX, cellY)].push_back(id);
+        }
+    }
+
+    selectedCount++;
+    totalArea += entry.area;
+    totalM10 += entry.moments.m10;
+    totalM01 += entry.moments.m01;
+}
+
+void SelectionSet::deselect(int id) {
+    Entry& entry = entries[id];
+    entry.selected = false;
+
+    const cv::Rect& box = entry.boundingBox;
+    for (int cellY = box.y / cellSize; cellY <= (box.y + box.height - 1) / cellSize; cellY++) {
+        for (int cellX = box.x / cellSize; cellX <= (box.x + box.width - 1) / cellSize; cellX++) {
+            auto cell = grid.find(getCellKey(cellX, cellY));
+            if (cell == grid.end()) {
+                continue;
+            }
+
+            std::vector<int>& ids = cell->second;
+            ids.erase(std::remove(ids.begin(), ids.end(), id), ids.end());
+            if (ids.empty()) {
+                grid.erase(cell);
+            }
+        }
+    }
+
+    selectedCount--;
+    totalArea -= entry.area;
+    totalM10 -= entry.moments.m10;
+    totalM01 -= entry.moments.m01;
+}
+
+int SelectionSet::add(const std::vector<cv::Point>& contour) {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    if (contour.empty()) {
+        return -1;
+    }
+
+    cv::Rect box = cv::boundingRect(contour);
+    std::vector<int> candidates = findCandidates(box);
+
+    // Already covered by a selected contour
+    for (int id : candidates) {
+        if (encloses(entries[id], contour, box)) {
+            return id;
+        }
+    }
+
+    Entry entry;
+    entry.contour = contour;
+    entry.boundingBox = box;
+    entry.area = cv::contourArea(contour);
+    entry.moments = cv::moments(contour);
+    entry.selected = false;
+
+    UndoRecord record;
+    record.added = static_cast<int>(entries.size());
+
+    // Selected contours inside the new one are replaced by it
+    for (int id : candidates) {
+        if (encloses(entry, entries[id].contour, entries[id].boundingBox)) {
+            deselect(id);
+            record.replaced.push_back(id);
+        }
+    }
+
+    entries.push_back(std::move(entry));
+    select(record.added);
+    undoStack.push_back(std::move(record));
+
+    return undoStack.back().added;
+}
+
+int SelectionSet::findAt(cv::Point point) const {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    if (point.x < 0 || point.y < 0) {
+        return -1;
+    }
+
+    auto cell = grid.find(getCellKey(point.x / cellSize, point.y / cellSize));
+    if (cell == grid.end()) {
+        return -1;
+    }
+
+    for (int id : cell->second) {
+        const Entry& entry = entries[id];
+        if (entry.boundingBox.contains(point) && cv::pointPolygonTest(entry.contour, point, false) >= 0) {
+            return id;
+        }
+    }
+
+    return -1;
+}
+
+bool SelectionSet::undo() {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    if (undoStack.empty()) {
+        return false;
+    }
+
+    UndoRecord& record = undoStack.back();
+    deselect(record.added);
+    for (int id : record.replaced) {
+        select(id);
+    }
+
+    // Records and entries are pushed together, so the undone entry is always the newest one
+    entries.pop_back();
+    undoStack.pop_back();
+
+    return true;
+}
+
+void SelectionSet::clear() {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    entries.clear();
+    undoStack.clear();
+    grid.clear();
+    visited.clear();
+    selectedCount = 0;
+    totalArea = 0;
+    totalM10 = 0;
+    totalM01 = 0;
+}
+
+size_t SelectionSet::size() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return selectedCount;
+}
+
+bool SelectionSet::empty() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return selectedCount == 0;
+}
+
+double SelectionSet::getTotalArea() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return totalArea;
+}
+
+cv::Point2f SelectionSet::getCentroid() const {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    if (selectedCount == 0 || totalArea <= 0) {
+        return cv::Point2f(-1, -1);
+    }
+
+    return cv::Point2f(static_cast<float>(totalM10 / totalArea), static_cast<float>(totalM01 / totalArea));
+}
+
+std::vector<cv::Point> SelectionSet::getContour(int id) const {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    if (id < 0 || id >= static_cast<int>(entries.size()) || !entries[id].selected) {
+        return std::vector<cv::Point>();
+    }
+
+    return entries[id].contour;
+}
+
+std::vector<std::vector<cv::Point>> SelectionSet::getContours() const {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    std::vector<std::vector<cv::Point>> contours;
+    contours.reserve(selectedCount);
+    for (const Entry& entry : entries) {
+        if (entry.selected) {
+            contours.push_back(entry.contour);
+        }
+    }
+
+    return contours;
+}
+
+void SelectionSet::draw(cv::Mat& image, const cv::Scalar& color, int thickness) const {
+    std::vector<std::vector<cv::Point>> contours = getContours();
+    cv::drawContours(image, contours, -1, color, thickness);
+}
@@ -0,0 +1,82 @@
+#ifndef SELECTIONSET_HPP
+#define SELECTIONSET_HPP
+
+#include <opencv2/opencv.hpp>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+using namespace cv;
+
+// Set of selected object contours for click-to-select sessions, safe to use from several threads.
+// Contours are found through a grid of bounding boxes, so a click only tests the contours near it.
+// Total area and area-weighted centroid are kept up to date as contours are added and removed.
+// A contour inside an already selected one is not added again, and adding a contour that encloses
+// selected ones replaces them. Every add can be undone in the reverse order.
+class SelectionSet {
+public:
+    explicit SelectionSet(int cellSize = 64);
+
+    // Adds the contour and returns its id, or returns the id of the selected contour that already
+    // encloses it. Selected contours that the new one encloses are removed.
+    int add(const std::vector<cv::Point>& contour);
+
+    // Id of the selected contour containing the point, -1 if there is none
+    int findAt(cv::Point point) const;
+
+    // Reverts the most recent add, bringing back any contours it replaced. False if there is nothing to undo.
+    bool undo();
+
+    void clear();
+
+    size_t size() const;
+    bool empty() const;
+    double getTotalArea() const;
+
+    // Centroid of all selected contours together, weighted by area; (-1, -1) when nothing is selected
+    cv::Point2f getCentroid() const;
+
+    // Copies, since the set may change on another thread
+    std::vector<cv::Point> getContour(int id) const;
+    std::vector<std::vector<cv::Point>> getContours() const;
+
+    // Draws the outlines of all selected contours
+    void draw(cv::Mat& image, const cv::Scalar& color, int thickness) const;
+
+private:
+    struct Entry {
+        std::vector<cv::Point> contour;
+        cv::Rect boundingBox;
+        double area;
+        cv::Moments moments;
+        bool selected;
+    };
+
+    // One add: the contour it selected and the ones it replaced
+    struct UndoRecord {
+        int added;
+        std::vector<int> replaced;
+    };
+
+    int cellSize;
+    std::vector<Entry> entries;
+    std::vector<UndoRecord> undoStack;
+    std::unordered_map<long long, std::vector<int>> grid;
+    size_t selectedCount = 0;
+    double totalArea = 0;
+    double totalM10 = 0;
+    double totalM01 = 0;
+
+    // Marks which entries were already looked at while scanning several grid cells
+    mutable std::vector<unsigned> visited;
+    mutable unsigned visitStamp = 0;
+
+    mutable std::mutex mutex;
+
+    long long getCellKey(int cellX, int cellY) const;
+    std::vector<int> findCandidates(const cv::Rect& box) const;
+    bool encloses(const Entry& outer, const std::vector<cv::Point>& inner, const cv::Rect& innerBox) const;
+    void select(int id);
+    void deselect(int id);
+};
+
+#endif // SELECTIONSET_HPP
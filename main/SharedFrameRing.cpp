@@ -0,0 +1,271 @@
+#include "SharedFrameRing.hpp"
+#include <atomic>
+#include <iostream>
+#include <cerrno>
+#include <new>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// The counters are shared between processes, which only works for lock-free atomics
+static_assert(ATOMIC_LLONG_LOCK_FREE == 2 && ATOMIC_INT_LOCK_FREE == 2, "shared counters need lock-free atomics");
+
+namespace {
+    const uint32_t ringMagic = 0x4F444652;
+    const size_t pageBytes = 4096;
+
+    size_t alignToPage(size_t bytes) {
+        return (bytes + pageBytes - 1) / pageBytes * pageBytes;
+    }
+}
+
+// Start of the shared memory, followed by one timestamp per slot, then the page-aligned slots.
+// The producer and consumer counters sit on separate cache lines so the two sides do not contend.
+struct SharedFrameRing::Header {
+    // Set to ringMagic last by create, so open never sees a half-initialized ring
+    std::atomic<uint32_t> ready;
+    int32_t width;
+    int32_t height;
+    int32_t type;
+    int32_t slotCount;
+    uint64_t slotBytes;
+    uint64_t slotsOffset;
+    // Process that created the ring, and the consumer attached to it (0 while there is none)
+    int32_t ownerPid;
+    std::atomic<int32_t> consumerPid;
+
+    // Frames published by the producer
+    alignas(64) std::atomic<uint64_t> written;
+    // Frames released by the consumer
+    alignas(64) std::atomic<uint64_t> read;
+    alignas(64) std::atomic<uint32_t> finished;
+};
+
+SharedFrameRing::~SharedFrameRing() {
+    close();
+}
+
+bool SharedFrameRing::create(const std::string& name, cv::Size frameSize, int type, int slotCount) {
+    close();
+
+    if (frameSize.width <= 0 || frameSize.height <= 0 || slotCount <= 0) {
+        std::cerr << "Error: Invalid frame ring geometry." << std::endl;
+        return false;
+    }
+
+    size_t frameBytes = static_cast<size_t>(frameSize.area()) * CV_ELEM_SIZE(type);
+    size_t slotBytes = alignToPage(frameBytes);
+    size_t slotsOffset = alignToPage(sizeof(Header) + sizeof(int64_t) * slotCount);
+    size_t totalBytes = slotsOffset + slotBytes * slotCount;
+
+    // A ring left behind by a crashed producer, or one that was never finished, is replaced;
+    // a ring whose creator is still running belongs to another producer
+    int existing = ::shm_open(name.c_str(), O_RDWR, 0);
+    if (existing >= 0) {
+        struct stat info;
+        int32_t existingOwner = 0;
+        if (::fstat(existing, &info) == 0 && static_cast<size_t>(info.st_size) >= sizeof(Header)) {
+            void* memory = ::mmap(nullptr, sizeof(Header), PROT_READ, MAP_SHARED, existing, 0);
+            if (memory != MAP_FAILED) {
+                const Header* mapped = static_cast<const Header*>(memory);
+                if (mapped->ready.load(std::memory_order_acquire) == ringMagic) {
+                    existingOwner = mapped->ownerPid;
+                }
+                ::munmap(memory, sizeof(Header));
+            }
+        }
+        ::close(existing);
+
+        if (existingOwner != 0 && isProcessAlive(existingOwner)) {
+            std::cerr << "Error: The shared frame ring is in use by process " << existingOwner << "." << std::endl;
+            return false;
+        }
+        ::shm_unlink(name.c_str());
+    }
+
+    int fd = ::shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0) {
+        std::cerr << "Error: Could not create the shared frame ring." << std::endl;
+        return false;
+    }
+
+    void* memory = MAP_FAILED;
+    if (::ftruncate(fd, static_cast<off_t>(totalBytes)) == 0) {
+        memory = ::mmap(nullptr, totalBytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    ::close(fd);
+
+    if (memory == MAP_FAILED) {
+        ::shm_unlink(name.c_str());
+        std::cerr << "Error: Could not map the shared frame ring." << std::endl;
+        return false;
+    }
+
+    this->name = name;
+    owner = true;
+    mapping = memory;
+    mappingBytes = totalBytes;
+    slots = static_cast<unsigned char*>(memory) + slotsOffset;
+
+    header = new (memory) Header();
+    header->width = frameSize.width;
+    header->height = frameSize.height;
+    header->type = type;
+    header->slotCount = slotCount;
+    header->slotBytes = slotBytes;
+    header->slotsOffset = slotsOffset;
+    header->ownerPid = static_cast<int32_t>(::getpid());
+    header->consumerPid.store(0, std::memory_order_relaxed);
+    header->written.store(0, std::memory_order_relaxed);
+    header->read.store(0, std::memory_order_relaxed);
+    header->finished.store(0, std::memory_order_relaxed);
+    header->ready.store(ringMagic, std::memory_order_release);
+
+    return true;
+}
+
+bool SharedFrameRing::open(const std::string& name) {
+    close();
+
+    int fd = ::shm_open(name.c_str(), O_RDWR, 0);
+    if (fd < 0) {
+        return false;
+    }
+
+    struct stat info;
+    void* memory = MAP_FAILED;
+    if (::fstat(fd, &info) == 0 && static_cast<size_t>(info.st_size) >= sizeof(Header)) {
+        memory = ::mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    ::close(fd);
+
+    if (memory == MAP_FAILED) {
+        return false;
+    }
+
+    Header* mapped = static_cast<Header*>(memory);
+    bool valid = mapped->ready.load(std::memory_order_acquire) == ringMagic
+        && mapped->slotsOffset + mapped->slotBytes * static_cast<uint64_t>(mapped->slotCount) <= static_cast<uint64_t>(info.st_size);
+    if (!valid) {
+        ::munmap(memory, static_cast<size_t>(info.st_size));
+        return false;
+    }
+
+    this->name = name;
+    owner = false;
+    mapping = memory;
+    mappingBytes = static_cast<size_t>(info.st_size);
+    header = mapped;
+    slots = static_cast<unsigned char*>(memory) + mapped->slotsOffset;
+    header->consumerPid.store(static_cast<int32_t>(::getpid()), std::memory_order_release);
+
+    return true;
+}
+
+void SharedFrameRing::close() {
+    // A consumer that leaves lets the producer stop waiting for it
+    if (header && !owner) {
+        int32_t self = static_cast<int32_t>(::getpid());
+        header->consumerPid.compare_exchange_strong(self, 0, std::memory_order_release);
+    }
+
+    if (mapping) {
+        ::munmap(mapping, mappingBytes);
+    }
+
+    // Processes that still have the ring mapped keep using it; only the name goes away
+    if (owner) {
+        ::shm_unlink(name.c_str());
+    }
+
+    name.clear();
+    owner = false;
+    mapping = nullptr;
+    mappingBytes = 0;
+    header = nullptr;
+    slots = nullptr;
+}
+
+cv::Mat SharedFrameRing::getSlot(uint64_t sequence) const {
+    unsigned char* data = slots + (sequence % static_cast<uint64_t>(header->slotCount)) * header->slotBytes;
+    return cv::Mat(header->height, header->width, header->type, data);
+}
+
+int64_t* SharedFrameRing::getTimestamp(uint64_t sequence) const {
+    int64_t* timestamps = reinterpret_cast<int64_t*>(header + 1);
+    return timestamps + sequence % static_cast<uint64_t>(header->slotCount);
+}
+
+bool SharedFrameRing::beginWrite(cv::Mat& slot) {
+    uint64_t written = header->written.load(std::memory_order_relaxed);
+    if (written - header->read.load(std::memory_order_acquire) >= static_cast<uint64_t>(header->slotCount)) {
+        return false;
+    }
+
+    slot = getSlot(written);
+    return true;
+}
+
+void SharedFrameRing::endWrite(int64_t timestamp) {
+    uint64_t written = header->written.load(std::memory_order_relaxed);
+    *getTimestamp(written) = timestamp;
+    header->written.store(written + 1, std::memory_order_release);
+}
+
+void SharedFrameRing::finish() {
+    header->finished.store(1, std::memory_order_release);
+}
+
+bool SharedFrameRing::beginRead(cv::Mat& frame, int64_t& timestamp) {
+    uint64_t read = header->read.load(std::memory_order_relaxed);
+    if (read == header->written.load(std::memory_order_acquire)) {
+        return false;
+    }
+
+    frame = getSlot(read);
+    timestamp = *getTimestamp(read);
+    return true;
+}
+
+void SharedFrameRing::endRead() {
+    uint64_t read = header->read.load(std::memory_order_relaxed);
+    header->read.store(read + 1, std::memory_order_release);
+}
+
+bool SharedFrameRing::isFinished() const {
+    // Check finished first: frames published before it are then visible to the comparison
+    return header->finished.load(std::memory_order_acquire) != 0
+        && header->read.load(std::memory_order_relaxed) == header->written.load(std::memory_order_acquire);
+}
+
+bool SharedFrameRing::isConsumerAttached() const {
+    int32_t pid = header ? header->consumerPid.load(std::memory_order_acquire) : 0;
+    return pid != 0 && isProcessAlive(pid);
+}
+
+bool SharedFrameRing::isProcessAlive(int pid) {
+    // EPERM means the process exists but belongs to another user
+    return ::kill(pid, 0) == 0 || errno == EPERM;
+}
+
+bool SharedFrameRing::isOpen() const {
+    return header != nullptr;
+}
+
+cv::Size SharedFrameRing::getFrameSize() const {
+    return header ? cv::Size(header->width, header->height) : cv::Size();
+}
+
+int SharedFrameRing::getType() const {
+    return header ? header->type : 0;
+}
+
+int SharedFrameRing::getSlotCount() const {
+    return header ? header->slotCount : 0;
+}
+
+uint64_t SharedFrameRing::getWrittenCount() const {
+    return header ? header->written.load(std::memory_order_acquire) : 0;
+}
@@ -0,0 +1,80 @@
+#ifndef SHAREDFRAMERING_HPP
+#define SHAREDFRAMERING_HPP
+
+#include <opencv2/opencv.hpp>
+#include <cstdint>
+#include <string>
+using namespace cv;
+
+// Ring of fixed-size frame slots in POSIX shared memory, for handing decoded frames from a capture
+// process to the detector without encoding, files or copies. The producer writes into a slot through
+// a cv::Mat header on the shared pixels and publishes it; the consumer gets a cv::Mat header on the
+// same pixels, runs detection on it and releases the slot. Slots are handed over with two lock-free
+// sequence counters in the shared header, one advanced by each side, so there is exactly one producer
+// and one consumer. A full ring makes beginWrite return false rather than overwrite unread frames.
+//
+// Linux and other POSIX systems only (shm_open and mmap).
+class SharedFrameRing {
+public:
+    SharedFrameRing() = default;
+    ~SharedFrameRing();
+
+    SharedFrameRing(const SharedFrameRing&) = delete;
+    SharedFrameRing& operator=(const SharedFrameRing&) = delete;
+
+    // Creates the shared memory object name ("/frames") with slotCount slots of frameSize and type.
+    // A ring of the same name is only replaced when it was never finished being set up or the process
+    // that created it is gone; a ring still in use makes create fail. The name is removed again by
+    // close or the destructor.
+    bool create(const std::string& name, cv::Size frameSize, int type, int slotCount);
+
+    // Maps a ring made by create in another process and attaches to it as the consumer; false until its
+    // creator has finished setting it up
+    bool open(const std::string& name);
+
+    void close();
+
+    // Producer side. beginWrite points slot at the next free slot, false when every slot is still
+    // unread. endWrite publishes it with a timestamp, e.g. the capture time in std::chrono::steady_clock
+    // nanoseconds, which on Linux can be compared between processes.
+    bool beginWrite(cv::Mat& slot);
+    void endWrite(int64_t timestamp);
+
+    // Tells the consumer that no more frames will come
+    void finish();
+
+    // Consumer side. beginRead points frame at the oldest published slot, false when there is none.
+    // The pixels stay valid and unchanged until endRead hands the slot back to the producer.
+    bool beginRead(cv::Mat& frame, int64_t& timestamp);
+    void endRead();
+
+    // True once finish was called and every frame has been read
+    bool isFinished() const;
+
+    // True while a consumer has the ring open and its process is still running
+    bool isConsumerAttached() const;
+
+    bool isOpen() const;
+    cv::Size getFrameSize() const;
+    int getType() const;
+    int getSlotCount() const;
+
+    // Frames published so far
+    uint64_t getWrittenCount() const;
+
+private:
+    struct Header;
+
+    std::string name;
+    bool owner = false;
+    void* mapping = nullptr;
+    size_t mappingBytes = 0;
+    Header* header = nullptr;
+    unsigned char* slots = nullptr;
+
+    static bool isProcessAlive(int pid);
+    cv::Mat getSlot(uint64_t sequence) const;
+    int64_t* getTimestamp(uint64_t sequence) const;
+};
+
+#endif // SHAREDFRAMERING_HPP
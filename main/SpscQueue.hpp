@@ -0,0 +1,59 @@
+#ifndef SPSCQUEUE_HPP
+#define SPSCQUEUE_HPP
+
+#include <atomic>
+#include <vector>
+#include <cstddef>
+
+// Bounded lock-free queue for exactly one producer thread and one consumer thread.
+// push and pop never block; they return false when the queue is full or empty.
+template<typename T>
+class SpscQueue {
+public:
+    explicit SpscQueue(size_t capacity) : slots(capacity + 1) {
+    }
+
+    bool push(T&& item) {
+        size_t tail = tailIndex.load(std::memory_order_relaxed);
+        size_t next = increment(tail);
+        if (next == headIndex.load(std::memory_order_acquire)) {
+            return false;
+        }
+
+        slots[tail] = std::move(item);
+        tailIndex.store(next, std::memory_order_release);
+        return true;
+    }
+
+    bool pop(T& item) {
+        size_t head = headIndex.load(std::memory_order_relaxed);
+        if (head == tailIndex.load(std::memory_order_acquire)) {
+            return false;
+        }
+
+        item = std::move(slots[head]);
+        headIndex.store(increment(head), std::memory_order_release);
+        return true;
+    }
+
+    bool empty() const {
+        return headIndex.load(std::memory_order_acquire) == tailIndex.load(std::memory_order_acquire);
+    }
+
+    size_t capacity() const {
+        return slots.size() - 1;
+    }
+
+private:
+    size_t increment(size_t index) const {
+        return (index + 1) == slots.size() ? 0 : index + 1;
+    }
+
+    std::vector<T> slots;
+
+    // Kept on separate cache lines so producer and consumer do not invalidate each other
+    alignas(64) std::atomic<size_t> headIndex{ 0 };
+    alignas(64) std::atomic<size_t> tailIndex{ 0 };
+};
+
+#endif // SPSCQUEUE_HPP
\ No newline at end of file
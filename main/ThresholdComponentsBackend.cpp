@@ -0,0 +1,81 @@
+#include "ThresholdComponentsBackend.hpp"
+#include "Tracing.hpp"
+
+const char* ThresholdComponentsBackend::getName() const {
+    return "threshold-components";
+}
+
+size_t ThresholdComponentsBackend::getAllocationCount() const {
+    return arena.getAllocationCount();
+}
+
+void ThresholdComponentsBackend::segment(const cv::Mat& image, double minArea, FrameAnalysis& analysis) {
+    TRACE_SCOPE("segment");
+    arena.prepare(gray, image.size(), CV_8UC1);
+    if (image.channels() == 1) {
+        image.copyTo(gray);
+    }
+    else {
+        cv::cvtColor(image, gray, cv::COLOR_BGR2GRAY);
+    }
+
+    // Threshold the grayscale image to create a binary mask
+    arena.prepare(binary, image.size(), CV_8UC1);
+    {
+        TRACE_SCOPE("threshold");
+        cv::threshold(gray, binary, 0, 255, cv::THRESH_BINARY_INV | cv::THRESH_OTSU);
+    }
+
+    // Label 0 is the background
+    arena.prepare(labels, image.size(), CV_32SC1);
+    int labelCount;
+    {
+        TRACE_SCOPE("components");
+        labelCount = cv::connectedComponentsWithStats(binary, labels, stats, centroids, 8, CV_32S);
+    }
+
+    arena.prepare(componentMask, image.size(), CV_8UC1);
+
+    size_t count = 0;
+    for (int label = 1; label < labelCount; label++) {
+        double area = stats.at<int>(label, cv::CC_STAT_AREA);
+        if (area < minArea) {
+            continue;
+        }
+
+        cv::Rect box(stats.at<int>(label, cv::CC_STAT_LEFT), stats.at<int>(label, cv::CC_STAT_TOP),
+            stats.at<int>(label, cv::CC_STAT_WIDTH), stats.at<int>(label, cv::CC_STAT_HEIGHT));
+
+        // Trace the outline of this component only, inside its bounding box
+        cv::Mat mask = componentMask(cv::Rect(0, 0, box.width, box.height));
+        cv::compare(labels(box), label, mask, cv::CMP_EQ);
+        cv::findContours(mask, componentContours, cv::RETR_EXTERNAL, cv::CHAIN_APPROX_SIMPLE, box.tl());
+        if (componentContours.empty()) {
+            continue;
+        }
+
+        if (count == objectContours.size()) {
+            arena.resize(objectContours, count + 1);
+            arena.resize(objectAreas, count + 1);
+            arena.resize(objectCentroids, count + 1);
+            arena.resize(objectBoxes, count + 1);
+        }
+
+        // A component is 8-connected, so it has a single external contour
+        std::swap(objectContours[count], componentContours[0]);
+        objectAreas[count] = area;
+        objectCentroids[count] = cv::Point2f(static_cast<float>(centroids.at<double>(label, 0)), static_cast<float>(centroids.at<double>(label, 1)));
+        objectBoxes[count] = box;
+        count++;
+    }
+
+    objectContours.resize(count);
+    objectAreas.resize(count);
+    objectCentroids.resize(count);
+    objectBoxes.resize(count);
+
+    TRACE_COUNT("contours_found", labelCount - 1);
+    TRACE_COUNT("contours_filtered", labelCount - 1 - count);
+
+    analysis.assign(image.size(), objectContours, objectAreas, objectCentroids, objectBoxes, arena);
+}
@@ -0,0 +1,35 @@
+#ifndef THRESHOLDCOMPONENTSBACKEND_HPP
+#define THRESHOLDCOMPONENTSBACKEND_HPP
+
+#include <opencv2/opencv.hpp>
+#include <vector>
+#include "ScratchArena.hpp"
+#include "SegmentationBackend.hpp"
+using namespace cv;
+
+// Otsu threshold of the gray image (objects darker than the background, as in the experimental
+// writeContour functions) followed by connectedComponentsWithStats, which gives area, centroid and
+// bounding box of every object in one labelling pass. Areas are pixel counts. A contour is only
+// traced for objects above the minimum area, inside their bounding box.
+class ThresholdComponentsBackend : public SegmentationBackend {
+public:
+    void segment(const cv::Mat& image, double minArea, FrameAnalysis& analysis) override;
+    const char* getName() const override;
+    size_t getAllocationCount() const override;
+
+private:
+    ScratchArena arena;
+    cv::Mat gray;
+    cv::Mat binary;
+    cv::Mat labels;
+    cv::Mat stats;
+    cv::Mat centroids;
+    cv::Mat componentMask;
+    std::vector<std::vector<cv::Point>> componentContours;
+    std::vector<std::vector<cv::Point>> objectContours;
+    std::vector<double> objectAreas;
+    std::vector<cv::Point2f> objectCentroids;
+    std::vector<cv::Rect> objectBoxes;
+};
+
+#endif // THRESHOLDCOMPONENTSBACKEND_HPP
@@ -0,0 +1,53 @@
+#include "TileSource.hpp"
+#include <fstream>
+#include <iostream>
+
+MatTileSource::MatTileSource(const cv::Mat& image) : image(image) {
+    CV_Assert(image.type() == CV_8UC3);
+}
+
+cv::Size MatTileSource::getSize() const {
+    return image.size();
+}
+
+void MatTileSource::read(const cv::Rect& region, cv::Mat& tile) {
+    tile = image(region);
+}
+
+RawFileTileSource::RawFileTileSource(const std::string& path, cv::Size size, size_t headerBytes)
+    : path(path), size(size), headerBytes(headerBytes), opened(false) {
+
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file) {
+        std::cerr << "Error: Could not open the image file." << std::endl;
+        return;
+    }
+
+    unsigned long long required = headerBytes + static_cast<unsigned long long>(size.width) * size.height * 3;
+    if (static_cast<unsigned long long>(file.tellg()) < required) {
+        std::cerr << "Error: The image file is smaller than " << size.width << "x" << size.height << " pixels." << std::endl;
+        return;
+    }
+
+    opened = true;
+}
+
+bool RawFileTileSource::isOpened() const {
+    return opened;
+}
+
+cv::Size RawFileTileSource::getSize() const {
+    return size;
+}
+
+void RawFileTileSource::read(const cv::Rect& region, cv::Mat& tile) {
+    tile.create(region.size(), CV_8UC3);
+
+    // Each call opens its own stream, so tiles can be read in parallel without sharing a file position
+    std::ifstream file(path, std::ios::binary);
+    for (int y = 0; y < region.height; y++) {
+        unsigned long long offset = headerBytes + (static_cast<unsigned long long>(region.y + y) * size.width + region.x) * 3;
+        file.seekg(static_cast<std::streamoff>(offset));
+        file.read(reinterpret_cast<char*>(tile.ptr<uchar>(y)), static_cast<std::streamsize>(region.width) * 3);
+    }
+}
@@ -0,0 +1,51 @@
+#ifndef TILESOURCE_HPP
+#define TILESOURCE_HPP
+
+#include <opencv2/opencv.hpp>
+#include <string>
+using namespace cv;
+
+// Image that can be read one rectangle at a time, so images larger than memory can be processed in tiles
+class TileSource {
+public:
+    virtual ~TileSource() {
+    }
+
+    virtual cv::Size getSize() const = 0;
+
+    // Makes tile hold region (inside the image) as 8-bit BGR. May be called from several threads at once.
+    virtual void read(const cv::Rect& region, cv::Mat& tile) = 0;
+};
+
+// Tiles of an image already in memory, handed out as views without copying
+class MatTileSource : public TileSource {
+public:
+    explicit MatTileSource(const cv::Mat& image);
+
+    cv::Size getSize() const override;
+    void read(const cv::Rect& region, cv::Mat& tile) override;
+
+private:
+    cv::Mat image;
+};
+
+// Tiles of an uncompressed file of 8-bit BGR pixels stored row by row after an optional header,
+// read straight from disk so only the requested rows are ever in memory
+class RawFileTileSource : public TileSource {
+public:
+    RawFileTileSource(const std::string& path, cv::Size size, size_t headerBytes = 0);
+
+    // False when the file cannot be opened or is too short for the given size
+    bool isOpened() const;
+
+    cv::Size getSize() const override;
+    void read(const cv::Rect& region, cv::Mat& tile) override;
+
+private:
+    std::string path;
+    cv::Size size;
+    size_t headerBytes;
+    bool opened;
+};
+
+#endif // TILESOURCE_HPP
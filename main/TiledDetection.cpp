@@ -0,0 +1,298 @@
+#include "TiledDetection.hpp"
+#include <iostream>
+#include <mutex>
+#include <numeric>
+#include <set>
+#include <tuple>
+
+int TiledDetection::getTileCount() const {
+    return tileCount;
+}
+
+int TiledDetection::getStitchedCount() const {
+    return stitchedCount;
+}
+
+int TiledDetection::getOversizedCount() const {
+    return oversizedCount;
+}
+
+cv::Size TiledDetection::getLargestRegion() const {
+    return largestRegion;
+}
+
+bool TiledDetection::touchesInnerBorder(const cv::Rect& box, const cv::Rect& region, cv::Size imageSize) {
+    // Edges of the image are real object borders, only the region edges inside the image cut objects
+    return (region.x > 0 && box.x <= region.x + 1)
+        || (region.y > 0 && box.y <= region.y + 1)
+        || (region.br().x < imageSize.width && box.br().x >= region.br().x - 1)
+        || (region.br().y < imageSize.height && box.br().y >= region.br().y - 1);
+}
+
+cv::Rect TiledDetection::getTileCore(cv::Point point, cv::Size imageSize) const {
+    cv::Rect core((point.x / tileSize) * tileSize, (point.y / tileSize) * tileSize, tileSize, tileSize);
+    return core & cv::Rect(0, 0, imageSize.width, imageSize.height);
+}
+
+void TiledDetection::traceRegion(TileSource& source, const cv::Rect& core, int dilateIterations, EdgePreprocessor& preprocessor, RegionResult& result) const {
+    cv::Size imageSize = source.getSize();
+    int margin = preprocessor.getBorderMargin(dilateIterations);
+
+    // Read the region with its halo so the edge map inside the core matches the full image
+    cv::Rect padded = cv::Rect(core.x - margin, core.y - margin, core.width + 2 * margin, core.height + 2 * margin) & cv::Rect(0, 0, imageSize.width, imageSize.height);
+    cv::Mat tile, dilatedEdges;
+    source.read(padded, tile);
+    preprocessor.process(tile, dilatedEdges, dilateIterations);
+
+    std::vector<std::vector<cv::Point>> contours;
+    cv::findContours(dilatedEdges(core - padded.tl()), contours, cv::RETR_EXTERNAL, cv::CHAIN_APPROX_SIMPLE, core.tl());
+
+    for (auto& contour : contours) {
+        cv::Rect box = cv::boundingRect(contour);
+        if (touchesInnerBorder(box, core, imageSize)) {
+            result.pieces.push_back(box);
+            continue;
+        }
+
+        double area = cv::contourArea(contour);
+        if (area >= minArea) {
+            result.contours.push_back(std::move(contour));
+            result.areas.push_back(area);
+        }
+    }
+}
+
+FrameAnalysis TiledDetection::analyze(TileSource& source) {
+    cv::Size imageSize = source.getSize();
+    cv::Rect imageRect(0, 0, imageSize.width, imageSize.height);
+
+    // Same iteration count as a full-frame analysis of the whole image
+    int dilateIterations = 2 + ((imageSize.width + imageSize.height) / 1500);
+
+    int columns = (imageSize.width + tileSize - 1) / tileSize;
+    int rows = (imageSize.height + tileSize - 1) / tileSize;
+    tileCount = columns * rows;
+
+    // Trace every tile; each parallel chunk keeps one preprocessor for all its tiles
+    std::vector<RegionResult> tiles(tileCount);
+    cv::parallel_for_(cv::Range(0, tileCount), [&](const cv::Range& range) {
+        EdgePreprocessor preprocessor;
+        for (int i = range.start; i < range.end; i++) {
+            cv::Rect core(cv::Point((i % columns) * tileSize, (i / columns) * tileSize), cv::Size(tileSize, tileSize));
+            traceRegion(source, core & imageRect, dilateIterations, preprocessor, tiles[i]);
+        }
+    });
+
+    std::vector<std::vector<cv::Point>> contours;
+    std::vector<double> areas;
+    std::vector<cv::Rect> pieces;
+    std::vector<int> pieceTiles;
+    for (int i = 0; i < tileCount; i++) {
+        for (size_t j = 0; j < tiles[i].contours.size(); j++) {
+            contours.push_back(std::move(tiles[i].contours[j]));
+            areas.push_back(tiles[i].areas[j]);
+        }
+        for (const cv::Rect& piece : tiles[i].pieces) {
+            pieces.push_back(piece);
+            pieceTiles.push_back(i);
+        }
+        tiles[i] = RegionResult();
+    }
+
+    // Group pieces whose boxes touch, only looking at pieces of the same and neighbouring tiles
+    std::vector<int> parent(pieces.size());
+    std::iota(parent.begin(), parent.end(), 0);
+    auto findRoot = [&](int i) {
+        while (parent[i] != i) {
+            parent[i] = parent[parent[i]];
+            i = parent[i];
+        }
+        return i;
+    };
+
+    std::vector<std::vector<int>> tilePieces(tileCount);
+    for (size_t i = 0; i < pieces.size(); i++) {
+        tilePieces[pieceTiles[i]].push_back(static_cast<int>(i));
+    }
+
+    for (size_t i = 0; i < pieces.size(); i++) {
+        cv::Rect grown(pieces[i].x - 1, pieces[i].y - 1, pieces[i].width + 2, pieces[i].height + 2);
+        int tileX = pieceTiles[i] % columns;
+        int tileY = pieceTiles[i] / columns;
+
+        for (int y = std::max(tileY - 1, 0); y <= std::min(tileY + 1, rows - 1); y++) {
+            for (int x = std::max(tileX - 1, 0); x <= std::min(tileX + 1, columns - 1); x++) {
+                for (int j : tilePieces[y * columns + x]) {
+                    if ((grown & pieces[j]).area() > 0) {
+                        parent[findRoot(static_cast<int>(i))] = findRoot(j);
+                    }
+                }
+            }
+        }
+    }
+
+    // One region per group, covering all its pieces
+    std::vector<cv::Rect> groups;
+    std::vector<int> groupOf(pieces.size(), -1);
+    for (size_t i = 0; i < pieces.size(); i++) {
+        int root = findRoot(static_cast<int>(i));
+        if (groupOf[root] < 0) {
+            groupOf[root] = static_cast<int>(groups.size());
+            groups.push_back(pieces[i]);
+        }
+        else {
+            groups[groupOf[root]] |= pieces[i];
+        }
+    }
+
+    // Touching pieces can chain along a whole tile border in a dense image. Such a group is replaced by
+    // its pieces, each stitched on its own; objects found from several pieces are deduplicated below.
+    int maxRegionSide = maxStitchTiles * tileSize;
+    std::vector<bool> splitGroup(groups.size(), false);
+    for (size_t i = 0; i < groups.size(); i++) {
+        splitGroup[i] = groups[i].width + 4 > maxRegionSide || groups[i].height + 4 > maxRegionSide;
+    }
+    for (size_t i = 0; i < pieces.size(); i++) {
+        if (splitGroup[groupOf[findRoot(static_cast<int>(i))]]) {
+            groups.push_back(pieces[i]);
+        }
+    }
+    for (size_t i = splitGroup.size(); i-- > 0;) {
+        if (splitGroup[i]) {
+            groups.erase(groups.begin() + i);
+        }
+    }
+
+    // Trace each group again, growing its region until the group's objects are no longer cut off by the region
+    // border. Other pieces at the border belong to neighbours, which are left to their own group or tile;
+    // growing for them as well would spread the region over every touching neighbour in a dense image.
+    // A region that would outgrow maxRegionSide is given up before it is traced.
+    std::vector<RegionResult> stitched(groups.size());
+    std::vector<cv::Size> regionSizes(groups.size());
+    std::vector<cv::Rect> oversized(groups.size());
+    cv::parallel_for_(cv::Range(0, static_cast<int>(groups.size())), [&](const cv::Range& range) {
+        EdgePreprocessor preprocessor;
+        for (int i = range.start; i < range.end; i++) {
+            cv::Rect objectBox = groups[i];
+            cv::Rect region = cv::Rect(objectBox.x - 2, objectBox.y - 2, objectBox.width + 4, objectBox.height + 4) & imageRect;
+
+            while (true) {
+                if (region.width > maxRegionSide || region.height > maxRegionSide) {
+                    oversized[i] = objectBox;
+                    break;
+                }
+
+                RegionResult result;
+                traceRegion(source, region, dilateIterations, preprocessor, result);
+                regionSizes[i] = region.size();
+
+                // A piece overlapping the group's objects means one of them still continues outside the region
+                bool cut = false;
+                cv::Rect grownBox = objectBox;
+                for (const cv::Rect& piece : result.pieces) {
+                    if ((piece & objectBox).area() > 0) {
+                        cut = true;
+                        grownBox |= piece;
+                        region |= cv::Rect(piece.x - 64, piece.y - 64, piece.width + 128, piece.height + 128);
+                    }
+                }
+
+                if (!cut) {
+                    stitched[i] = std::move(result);
+                    break;
+                }
+                objectBox = grownBox;
+                region &= imageRect;
+            }
+        }
+    });
+
+    largestRegion = tileCount > 0 ? cv::Size(std::min(tileSize, imageSize.width), std::min(tileSize, imageSize.height)) : cv::Size();
+    for (const cv::Size& size : regionSizes) {
+        largestRegion.width = std::max(largestRegion.width, size.width);
+        largestRegion.height = std::max(largestRegion.height, size.height);
+    }
+
+    // Pieces of one oversized object were given up separately; count the object once
+    std::vector<cv::Rect> oversizedObjects;
+    for (const cv::Rect& box : oversized) {
+        if (box.area() == 0) {
+            continue;
+        }
+        cv::Rect merged = box;
+        for (size_t j = oversizedObjects.size(); j-- > 0;) {
+            if ((oversizedObjects[j] & merged).area() > 0) {
+                merged |= oversizedObjects[j];
+                oversizedObjects.erase(oversizedObjects.begin() + j);
+                j = oversizedObjects.size();
+            }
+        }
+        oversizedObjects.push_back(merged);
+    }
+    oversizedCount = static_cast<int>(oversizedObjects.size());
+    if (oversizedCount > 0) {
+        std::cerr << "Error: " << oversizedCount << " objects span more than " << maxStitchTiles
+            << " tiles and are missing from the tiled result." << std::endl;
+    }
+
+    // Keep the objects that cross a tile border; the others were already found by their tile.
+    // Groups can overlap, so an object found twice is only kept once.
+    size_t tileObjects = contours.size();
+    std::set<std::tuple<int, int, int, int>> seen;
+    for (RegionResult& result : stitched) {
+        for (size_t j = 0; j < result.contours.size(); j++) {
+            cv::Rect box = cv::boundingRect(result.contours[j]);
+            cv::Rect core = getTileCore(box.tl(), imageSize);
+            bool foundByTile = (core & box) == box && !touchesInnerBorder(box, core, imageSize);
+            if (foundByTile || !seen.insert(std::make_tuple(box.x, box.y, box.width, box.height)).second) {
+                continue;
+            }
+
+            contours.push_back(std::move(result.contours[j]));
+            areas.push_back(result.areas[j]);
+        }
+    }
+
+    // A tile only sees pieces of an object crossing its border, so it keeps outlines nested inside that
+    // object which the full-frame RETR_EXTERNAL drops. Drop every outline enclosed by a stitched object,
+    // looking only at the outlines of the tiles the stitched object covers.
+    std::vector<cv::Rect> boxes(contours.size());
+    std::vector<std::vector<int>> tileContours(tileCount);
+    for (size_t i = 0; i < contours.size(); i++) {
+        boxes[i] = cv::boundingRect(contours[i]);
+        tileContours[(boxes[i].y / tileSize) * columns + boxes[i].x / tileSize].push_back(static_cast<int>(i));
+    }
+
+    std::vector<bool> enclosed(contours.size(), false);
+    for (size_t i = tileObjects; i < contours.size(); i++) {
+        const cv::Rect& outer = boxes[i];
+        for (int y = outer.y / tileSize; y <= (outer.br().y - 1) / tileSize; y++) {
+            for (int x = outer.x / tileSize; x <= (outer.br().x - 1) / tileSize; x++) {
+                for (int j : tileContours[y * columns + x]) {
+                    if (j != static_cast<int>(i) && (outer & boxes[j]) == boxes[j] && boxes[j] != outer
+                        && cv::pointPolygonTest(contours[i], contours[j][0], false) > 0) {
+                        enclosed[j] = true;
+                    }
+                }
+            }
+        }
+    }
+
+    size_t count = 0;
+    stitchedCount = 0;
+    for (size_t i = 0; i < contours.size(); i++) {
+        if (enclosed[i]) {
+            continue;
+        }
+        if (i >= tileObjects) {
+            stitchedCount++;
+        }
+        std::swap(contours[count], contours[i]);
+        areas[count] = areas[i];
+        count++;
+    }
+    contours.resize(count);
+    areas.resize(count);
+
+    return FrameAnalysis(imageSize, std::move(contours), std::move(areas));
+}
@@ -0,0 +1,66 @@
+#ifndef TILEDDETECTION_HPP
+#define TILEDDETECTION_HPP
+
+#include <opencv2/opencv.hpp>
+#include <vector>
+#include "EdgePreprocessor.hpp"
+#include "FrameAnalysis.hpp"
+#include "TileSource.hpp"
+using namespace cv;
+
+// Runs the Canny-contour pipeline of ObjectDetection on an image tile by tile, so memory use depends on
+// the tile size and thread count instead of the image size. Every tile is read with a halo as wide as
+// the border effects of blur, Canny and dilation (see EdgePreprocessor::getBorderMargin), and tiles run
+// in parallel.
+// Objects inside one tile are kept as they are. Pieces of objects that cross tile borders are grouped
+// by touching bounding boxes, and each group is traced again in a region grown until it covers the
+// group's objects; pieces of neighbours cut by that region are left to their own group. Outlines a tile
+// kept but that lie inside a stitched object are dropped, as the full-frame external contours would.
+// Results are in full-image coordinates and match a full-frame analysis up to the order of the objects,
+// with the same weak-edge caveat as ObjectDetection::analyzeAround.
+//
+// A stitching region is never wider or taller than maxStitchTiles tiles, so each thread holds at most
+// one such region with its halo. A group of pieces larger than that is traced piece by piece, and an
+// object that does not fit is reported as an error and left out of the result, while the outlines
+// nested inside it stay in (see getOversizedCount).
+class TiledDetection {
+public:
+    FrameAnalysis analyze(TileSource& source);
+
+    // Tiles and stitched objects of the last analyze
+    int getTileCount() const;
+    int getStitchedCount() const;
+
+    // Objects of the last analyze that crossed tile borders but did not fit in a stitching region
+    int getOversizedCount() const;
+
+    // Largest region of the last analyze, tile or stitching region, without its halo
+    cv::Size getLargestRegion() const;
+
+    // Side of the square tiles without their halo
+    int tileSize = 2048;
+    int minArea = 2000;
+
+    // Largest side of a stitching region, in tiles
+    int maxStitchTiles = 2;
+
+private:
+    int tileCount = 0;
+    int stitchedCount = 0;
+    int oversizedCount = 0;
+    cv::Size largestRegion;
+
+    // Objects found in a tile or stitching region: complete contours, and bounding boxes of the pieces
+    // that touch an inner region border and so continue outside it
+    struct RegionResult {
+        std::vector<std::vector<cv::Point>> contours;
+        std::vector<double> areas;
+        std::vector<cv::Rect> pieces;
+    };
+
+    void traceRegion(TileSource& source, const cv::Rect& core, int dilateIterations, EdgePreprocessor& preprocessor, RegionResult& result) const;
+    cv::Rect getTileCore(cv::Point point, cv::Size imageSize) const;
+    static bool touchesInnerBorder(const cv::Rect& box, const cv::Rect& region, cv::Size imageSize);
+};
+
+#endif // TILEDDETECTION_HPP
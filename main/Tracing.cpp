@@ -0,0 +1,376 @@
+#include "Tracing.hpp"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace {
+    // Upper bounds of the latency buckets in seconds, roughly 1-2.5-5 steps from 1 us to 10 s
+    const double bucketBounds[] = { 1e-6, 2.5e-6, 5e-6, 1e-5, 2.5e-5, 5e-5, 1e-4, 2.5e-4, 5e-4, 1e-3, 2.5e-3, 5e-3,
+        1e-2, 2.5e-2, 5e-2, 0.1, 0.25, 0.5, 1, 2.5, 5, 10 };
+    const int bucketCount = sizeof(bucketBounds) / sizeof(bucketBounds[0]);
+
+    // Fields are atomic because an export may read a slot while its thread overwrites it; see ThreadBuffer
+    struct TraceEvent {
+        std::atomic<int> stage;
+        std::atomic<int64_t> start;
+        std::atomic<int64_t> end;
+    };
+
+    // Plain copy of a thread's histograms and counters
+    struct Totals {
+        std::array<std::array<uint64_t, bucketCount + 1>, Tracing::maxStages> buckets = {};
+        std::array<uint64_t, Tracing::maxStages> stageCounts = {};
+        std::array<uint64_t, Tracing::maxStages> stageNanoseconds = {};
+        std::array<uint64_t, Tracing::maxCounters> counters = {};
+    };
+
+    // Written by its own thread only; other threads just read it when exporting.
+    // Event slots work like a seqlock: the owner bumps begun before overwriting a slot and written after,
+    // so an export that copied a slot can tell from begun whether the slot was overwritten meanwhile.
+    struct ThreadBuffer {
+        uint32_t threadId = 0;
+        std::atomic<uint64_t> begun{ 0 };
+        std::atomic<uint64_t> written{ 0 };
+        std::array<TraceEvent, Tracing::ringCapacity> events;
+
+        // Per stage: one count per bucket plus the overflow bucket, the event count and the summed nanoseconds
+        std::array<std::array<std::atomic<uint64_t>, bucketCount + 1>, Tracing::maxStages> buckets;
+        std::array<std::atomic<uint64_t>, Tracing::maxStages> stageCounts;
+        std::array<std::atomic<uint64_t>, Tracing::maxStages> stageNanoseconds;
+        std::array<std::atomic<uint64_t>, Tracing::maxCounters> counters;
+
+        // Only the owner writes the atomics above, so reset never clears them: it records what they held
+        // and exports subtract that. Only used under the registry mutex.
+        uint64_t eventsBaseline = 0;
+        Totals baseline;
+
+        ThreadBuffer() {
+            for (auto& stage : buckets) {
+                for (auto& bucket : stage) {
+                    bucket.store(0, std::memory_order_relaxed);
+                }
+            }
+            for (int i = 0; i < Tracing::maxStages; i++) {
+                stageCounts[i].store(0, std::memory_order_relaxed);
+                stageNanoseconds[i].store(0, std::memory_order_relaxed);
+            }
+            for (auto& counter : counters) {
+                counter.store(0, std::memory_order_relaxed);
+            }
+        }
+
+        Totals getTotals() const {
+            Totals totals;
+            for (int stage = 0; stage < Tracing::maxStages; stage++) {
+                for (int i = 0; i <= bucketCount; i++) {
+                    totals.buckets[stage][i] = buckets[stage][i].load(std::memory_order_relaxed);
+                }
+                totals.stageCounts[stage] = stageCounts[stage].load(std::memory_order_relaxed);
+                totals.stageNanoseconds[stage] = stageNanoseconds[stage].load(std::memory_order_relaxed);
+            }
+            for (int i = 0; i < Tracing::maxCounters; i++) {
+                totals.counters[i] = counters[i].load(std::memory_order_relaxed);
+            }
+            return totals;
+        }
+
+        // Totals since the last reset
+        Totals getTotalsSinceReset() const {
+            Totals totals = getTotals();
+            for (int stage = 0; stage < Tracing::maxStages; stage++) {
+                for (int i = 0; i <= bucketCount; i++) {
+                    totals.buckets[stage][i] -= baseline.buckets[stage][i];
+                }
+                totals.stageCounts[stage] -= baseline.stageCounts[stage];
+                totals.stageNanoseconds[stage] -= baseline.stageNanoseconds[stage];
+            }
+            for (int i = 0; i < Tracing::maxCounters; i++) {
+                totals.counters[i] -= baseline.counters[i];
+            }
+            return totals;
+        }
+    };
+
+    void addTotals(Totals& into, const Totals& from) {
+        for (int stage = 0; stage < Tracing::maxStages; stage++) {
+            for (int i = 0; i <= bucketCount; i++) {
+                into.buckets[stage][i] += from.buckets[stage][i];
+            }
+            into.stageCounts[stage] += from.stageCounts[stage];
+            into.stageNanoseconds[stage] += from.stageNanoseconds[stage];
+        }
+        for (int i = 0; i < Tracing::maxCounters; i++) {
+            into.counters[i] += from.counters[i];
+        }
+    }
+
+    struct Registry {
+        std::mutex mutex;
+        std::vector<std::unique_ptr<ThreadBuffer>> threads;
+        // Buffers of threads that ended, handed to the next thread that records
+        std::vector<ThreadBuffer*> freeBuffers;
+        // Histograms and counters since the last reset of the threads that ended
+        Totals retired;
+        uint32_t nextThreadId = 1;
+        std::vector<const char*> stageNames;
+        std::vector<const char*> counterNames;
+    };
+
+    // Never destroyed, so threads ending after main can still record
+    Registry& getRegistry() {
+        static Registry* registry = new Registry();
+        return *registry;
+    }
+
+    // The buffer of the current thread. Kept in a plain pointer, since recording can still happen from
+    // destructors that run after ThreadBufferOwner's at thread exit.
+    thread_local ThreadBuffer* currentBuffer = nullptr;
+    thread_local bool ownerDestroyed = false;
+
+    // Gives the thread's buffer back when the thread ends. Its histograms and counters are moved into
+    // the registry's retired totals; its events stay exportable until another thread takes the buffer.
+    struct ThreadBufferOwner {
+        bool owns = false;
+
+        ~ThreadBufferOwner() {
+            ownerDestroyed = true;
+            if (!owns || !currentBuffer) {
+                return;
+            }
+
+            Registry& registry = getRegistry();
+            std::lock_guard<std::mutex> lock(registry.mutex);
+            addTotals(registry.retired, currentBuffer->getTotalsSinceReset());
+            currentBuffer->baseline = currentBuffer->getTotals();
+            registry.freeBuffers.push_back(currentBuffer);
+            currentBuffer = nullptr;
+        }
+    };
+
+    thread_local ThreadBufferOwner bufferOwner;
+
+    ThreadBuffer& getThreadBuffer() {
+        if (!currentBuffer) {
+            Registry& registry = getRegistry();
+            std::lock_guard<std::mutex> lock(registry.mutex);
+            if (!registry.freeBuffers.empty()) {
+                currentBuffer = registry.freeBuffers.back();
+                registry.freeBuffers.pop_back();
+
+                // Events of the thread that ended are not this thread's
+                currentBuffer->eventsBaseline = currentBuffer->written.load(std::memory_order_relaxed);
+            }
+            else {
+                registry.threads.emplace_back(new ThreadBuffer());
+                currentBuffer = registry.threads.back().get();
+            }
+            currentBuffer->threadId = registry.nextThreadId++;
+
+            // A thread recording after its owner was destroyed keeps the buffer for good
+            if (!ownerDestroyed) {
+                bufferOwner.owns = true;
+            }
+        }
+        return *currentBuffer;
+    }
+
+    // Single writer per buffer, so a relaxed load and store is enough and avoids a locked add
+    void increment(std::atomic<uint64_t>& value, uint64_t amount) {
+        value.store(value.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+    }
+
+    int registerName(std::vector<const char*>& names, const char* name, int limit) {
+        Registry& registry = getRegistry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+
+        for (size_t i = 0; i < names.size(); i++) {
+            if (std::strcmp(names[i], name) == 0) {
+                return static_cast<int>(i);
+            }
+        }
+        if (static_cast<int>(names.size()) >= limit) {
+            std::cerr << "Error: Too many trace names, " << name << " is not recorded." << std::endl;
+            return -1;
+        }
+
+        names.push_back(name);
+        return static_cast<int>(names.size()) - 1;
+    }
+}
+
+bool Tracing::isEnabled() {
+#ifdef OBJECTDETECTION_TRACING
+    return true;
+#else
+    return false;
+#endif
+}
+
+int Tracing::registerStage(const char* name) {
+    return registerName(getRegistry().stageNames, name, maxStages);
+}
+
+int Tracing::registerCounter(const char* name) {
+    return registerName(getRegistry().counterNames, name, maxCounters);
+}
+
+int64_t Tracing::now() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void Tracing::record(int stage, int64_t start, int64_t end) {
+    if (stage < 0) {
+        return;
+    }
+
+    ThreadBuffer& buffer = getThreadBuffer();
+
+    uint64_t index = buffer.written.load(std::memory_order_relaxed);
+    buffer.begun.store(index + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    TraceEvent& event = buffer.events[index % ringCapacity];
+    event.stage.store(stage, std::memory_order_relaxed);
+    event.start.store(start, std::memory_order_relaxed);
+    event.end.store(end, std::memory_order_relaxed);
+    buffer.written.store(index + 1, std::memory_order_release);
+
+    int64_t nanoseconds = end - start;
+    double seconds = nanoseconds * 1e-9;
+    int bucket = 0;
+    while (bucket < bucketCount && seconds > bucketBounds[bucket]) {
+        bucket++;
+    }
+
+    increment(buffer.buckets[stage][bucket], 1);
+    increment(buffer.stageCounts[stage], 1);
+    increment(buffer.stageNanoseconds[stage], static_cast<uint64_t>(nanoseconds));
+}
+
+void Tracing::add(int counter, uint64_t value) {
+    if (counter < 0) {
+        return;
+    }
+
+    increment(getThreadBuffer().counters[counter], value);
+}
+
+void Tracing::reset() {
+    Registry& registry = getRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+
+    for (auto& thread : registry.threads) {
+        thread->eventsBaseline = thread->written.load(std::memory_order_acquire);
+        thread->baseline = thread->getTotals();
+    }
+    registry.retired = Totals();
+}
+
+bool Tracing::writeChromeTrace(const std::string& path) {
+    std::ofstream file(path);
+    if (!file.is_open()) {
+        std::cerr << "Error: Could not open the trace file." << std::endl;
+        return false;
+    }
+
+    Registry& registry = getRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+
+    // Timestamps in microseconds since boot need more than the default six digits
+    file << std::fixed << std::setprecision(3);
+    file << "{\"traceEvents\":[";
+    bool first = true;
+    std::vector<std::array<int64_t, 3>> events;
+    for (auto& thread : registry.threads) {
+        uint64_t written = thread->written.load(std::memory_order_acquire);
+        uint64_t oldest = std::max(written > ringCapacity ? written - ringCapacity : 0, thread->eventsBaseline);
+
+        // Copy first, then drop the slots the owner started overwriting while they were copied
+        events.clear();
+        for (uint64_t i = oldest; i < written; i++) {
+            const TraceEvent& event = thread->events[i % ringCapacity];
+            events.push_back({ event.stage.load(std::memory_order_relaxed), event.start.load(std::memory_order_relaxed), event.end.load(std::memory_order_relaxed) });
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        uint64_t begun = thread->begun.load(std::memory_order_relaxed);
+        uint64_t firstIntact = begun > ringCapacity ? begun - ringCapacity : 0;
+
+        for (uint64_t i = std::max(oldest, firstIntact); i < written; i++) {
+            const std::array<int64_t, 3>& event = events[i - oldest];
+            if (event[0] < 0 || event[0] >= static_cast<int64_t>(registry.stageNames.size())) {
+                continue;
+            }
+
+            // Chrome expects microseconds
+            file << (first ? "" : ",") << "\n{\"name\":\"" << registry.stageNames[event[0]] << "\",\"ph\":\"X\",\"pid\":1,\"tid\":"
+                << thread->threadId << ",\"ts\":" << event[1] / 1000.0 << ",\"dur\":" << (event[2] - event[1]) / 1000.0 << "}";
+            first = false;
+        }
+    }
+    file << "\n],\"displayTimeUnit\":\"ms\"}\n";
+
+    return static_cast<bool>(file);
+}
+
+bool Tracing::writePrometheus(const std::string& path) {
+    std::ofstream file(path);
+    if (!file.is_open()) {
+        std::cerr << "Error: Could not open the metrics file." << std::endl;
+        return false;
+    }
+
+    Registry& registry = getRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+
+    std::vector<Totals> totals(1, registry.retired);
+    for (auto& thread : registry.threads) {
+        totals.push_back(thread->getTotalsSinceReset());
+    }
+
+    file << std::setprecision(9);
+    file << "# HELP objectdetection_stage_seconds Time spent in each detection stage.\n";
+    file << "# TYPE objectdetection_stage_seconds histogram\n";
+    for (size_t stage = 0; stage < registry.stageNames.size(); stage++) {
+        uint64_t buckets[bucketCount + 1] = {};
+        uint64_t count = 0;
+        uint64_t nanoseconds = 0;
+        for (const Totals& thread : totals) {
+            for (int i = 0; i <= bucketCount; i++) {
+                buckets[i] += thread.buckets[stage][i];
+            }
+            count += thread.stageCounts[stage];
+            nanoseconds += thread.stageNanoseconds[stage];
+        }
+
+        // Prometheus buckets are cumulative
+        const char* name = registry.stageNames[stage];
+        uint64_t cumulative = 0;
+        for (int i = 0; i < bucketCount; i++) {
+            cumulative += buckets[i];
+            file << "objectdetection_stage_seconds_bucket{stage=\"" << name << "\",le=\"" << bucketBounds[i] << "\"} " << cumulative << "\n";
+        }
+        file << "objectdetection_stage_seconds_bucket{stage=\"" << name << "\",le=\"+Inf\"} " << count << "\n";
+        file << "objectdetection_stage_seconds_sum{stage=\"" << name << "\"} " << nanoseconds * 1e-9 << "\n";
+        file << "objectdetection_stage_seconds_count{stage=\"" << name << "\"} " << count << "\n";
+    }
+
+    for (size_t counter = 0; counter < registry.counterNames.size(); counter++) {
+        uint64_t total = 0;
+        for (const Totals& thread : totals) {
+            total += thread.counters[counter];
+        }
+
+        const char* name = registry.counterNames[counter];
+        file << "# TYPE objectdetection_" << name << "_total counter\n";
+        file << "objectdetection_" << name << "_total " << total << "\n";
+    }
+
+    return static_cast<bool>(file);
+}
@@ -0,0 +1,82 @@
+#ifndef TRACING_HPP
+#define TRACING_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+// Scoped timing and counters for the detection pipeline, cheap enough to leave on in production.
+// Every thread writes into its own fixed ring buffer of recent events and its own histograms and
+// counters, so recording takes no lock. Exports are a Chrome trace (chrome://tracing, Perfetto)
+// of the buffered events, and Prometheus text with a latency histogram per stage and the counters.
+//
+// A thread's buffer takes about 400 KB, nearly all of it the event ring (ringCapacity events of
+// 24 bytes). It is allocated the first time the thread records. When the thread ends, its histograms
+// and counters are added to totals kept for ended threads and the buffer is handed to the next new
+// thread, so memory grows with the most threads recording at once, not with every thread ever started.
+//
+// Recording only happens through the macros below, which compile to nothing unless the library is
+// built with OBJECTDETECTION_TRACING defined (cmake -DOBJECTDETECTION_TRACING=ON). Exports then
+// write valid but empty files.
+class Tracing {
+public:
+    // Stage and counter names must be string literals; each call site registers its name once
+    static int registerStage(const char* name);
+    static int registerCounter(const char* name);
+
+    static int64_t now();
+    static void record(int stage, int64_t start, int64_t end);
+    static void add(int counter, uint64_t value);
+
+    // Events still in the ring buffers, as Chrome trace JSON. Events recorded while exporting may be skipped,
+    // and events overwritten while they were being copied are dropped rather than written torn.
+    static bool writeChromeTrace(const std::string& path);
+
+    // objectdetection_stage_seconds histograms and objectdetection_<counter>_total counters
+    static bool writePrometheus(const std::string& path);
+
+    // Starts the exports afresh: later exports only include events, histograms and counters recorded after
+    // this call. The recording threads' own values are left alone, so concurrent updates are never lost.
+    static void reset();
+
+    static bool isEnabled();
+
+    // Events each thread keeps; older ones are overwritten
+    static const size_t ringCapacity = 16384;
+    static const int maxStages = 64;
+    static const int maxCounters = 32;
+};
+
+// Records the time from construction to destruction as one event of stage
+class TraceScope {
+public:
+    explicit TraceScope(int stage) : stage(stage), start(Tracing::now()) {
+    }
+
+    ~TraceScope() {
+        Tracing::record(stage, start, Tracing::now());
+    }
+
+private:
+    int stage;
+    int64_t start;
+};
+
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+
+#ifdef OBJECTDETECTION_TRACING
+#define TRACE_SCOPE(name) \
+    static const int TRACE_CONCAT(traceStage, __LINE__) = Tracing::registerStage(name); \
+    TraceScope TRACE_CONCAT(traceScope, __LINE__)(TRACE_CONCAT(traceStage, __LINE__))
+#define TRACE_COUNT(name, value) \
+    do { \
+        static const int traceCounter = Tracing::registerCounter(name); \
+        Tracing::add(traceCounter, static_cast<uint64_t>(value)); \
+    } while (0)
+#else
+#define TRACE_SCOPE(name) do { } while (0)
+#define TRACE_COUNT(name, value) do { } while (0)
+#endif
+
+#endif // TRACING_HPP
@@ -0,0 +1,280 @@
+#include "VideoPipeline.hpp"
+#include "ObjectDetection.hpp"
+#include "SpscQueue.hpp"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+struct StreamFrame {
+    int64_t index = 0;
+    cv::Mat image;
+    FrameAnalysis analysis;
+};
+
+// Queue between two stages plus the flag the producing stage sets after its last frame.
+// A stage that finds the queue full or empty yields for a short while, then sleeps on the
+// condition variable until the other side pushes, pops or finishes.
+struct StageLink {
+    explicit StageLink(size_t capacity) : queue(capacity) {
+    }
+
+    // Fails instead of waiting when the queue is full; frame is left untouched then
+    bool tryPush(StreamFrame& frame) {
+        if (!queue.push(std::move(frame))) {
+            return false;
+        }
+        wake();
+        return true;
+    }
+
+    void push(StreamFrame& frame) {
+        wait([&]() { return queue.push(std::move(frame)); });
+        wake();
+    }
+
+    // Returns false once the producing stage has finished and the queue is drained
+    bool pop(StreamFrame& frame) {
+        bool popped = false;
+        wait([&]() {
+            popped = queue.pop(frame);
+            return popped || finished.load(std::memory_order_acquire);
+        });
+
+        // Frames pushed just before finishing are still queued
+        if (!popped) {
+            popped = queue.pop(frame);
+        }
+        if (popped) {
+            wake();
+        }
+        return popped;
+    }
+
+    void finish() {
+        finished.store(true, std::memory_order_release);
+        wake();
+    }
+
+private:
+    // Yields before sleeping, since the other stage usually frees a slot within one frame time
+    static const int spinCount = 64;
+
+    template<typename Ready>
+    void wait(Ready ready) {
+        for (int i = 0; i < spinCount; i++) {
+            if (ready()) {
+                return;
+            }
+            std::this_thread::yield();
+        }
+
+        std::unique_lock<std::mutex> lock(mutex);
+        sleepers.fetch_add(1);
+        // Pairs with the fence in wake: either the sleeper sees the change or wake sees the sleeper
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        changed.wait(lock, ready);
+        sleepers.fetch_sub(1);
+    }
+
+    // Only takes the mutex when the other stage is asleep, so the common case costs a fence
+    void wake() {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (sleepers.load(std::memory_order_relaxed) > 0) {
+            std::lock_guard<std::mutex> lock(mutex);
+            changed.notify_all();
+        }
+    }
+
+    SpscQueue<StreamFrame> queue;
+    std::atomic<bool> finished{ false };
+    std::atomic<int> sleepers{ 0 };
+    std::mutex mutex;
+    std::condition_variable changed;
+};
+
+static int64_t elapsedNanoseconds(std::chrono::high_resolution_clock::time_point start) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::high_resolution_clock::now() - start).count();
+}
+
+VideoPipeline::VideoPipeline(const VideoPipelineOptions& options) : options(options) {
+}
+
+void VideoPipeline::stop() {
+    stopRequested = true;
+}
+
+bool VideoPipeline::run(const std::string& source, const std::string& output) {
+    for (StageCounters* counters : { &decodeCounters, &detectCounters, &annotateCounters, &encodeCounters }) {
+        counters->frames = 0;
+        counters->dropped = 0;
+        counters->busyNanoseconds = 0;
+    }
+    stopRequested = false;
+
+    cv::VideoCapture capture;
+    bool isCamera = !source.empty() && std::all_of(source.begin(), source.end(), [](unsigned char c) { return std::isdigit(c) != 0; });
+    if (isCamera) {
+        capture.open(std::stoi(source));
+    }
+    else {
+        capture.open(source);
+    }
+
+    if (!capture.isOpened()) {
+        std::cerr << "Error: Could not open the video source." << std::endl;
+        return false;
+    }
+
+    double fps = capture.get(cv::CAP_PROP_FPS);
+    if (fps <= 0) {
+        fps = 30;
+    }
+
+    StageLink decoded(options.queueCapacity);
+    StageLink detected(options.queueCapacity);
+    StageLink annotated(options.queueCapacity);
+    std::atomic<bool> outputFailed(false);
+
+    auto start = std::chrono::high_resolution_clock::now();
+
+    std::thread decodeThread([&]() {
+        int64_t index = 0;
+
+        while (!stopRequested) {
+            StreamFrame frame;
+
+            auto stageStart = std::chrono::high_resolution_clock::now();
+            if (!capture.read(frame.image) || frame.image.empty()) {
+                break;
+            }
+            frame.index = index++;
+            decodeCounters.busyNanoseconds += elapsedNanoseconds(stageStart);
+
+            // Under backpressure either drop the new frame or wait for detection to catch up
+            if (options.dropFrames) {
+                if (!decoded.tryPush(frame)) {
+                    decodeCounters.dropped++;
+                    continue;
+                }
+            }
+            else {
+                decoded.push(frame);
+            }
+            decodeCounters.frames++;
+        }
+
+        decoded.finish();
+    });
+
+    std::thread detectThread([&]() {
+        ObjectDetection detection;
+        StreamFrame frame;
+
+        while (decoded.pop(frame)) {
+            auto stageStart = std::chrono::high_resolution_clock::now();
+            if (options.track) {
+                TrackedObject tracked = detection.trackCenterObject(frame.image);
+                std::vector<std::vector<cv::Point>> contours;
+                std::vector<double> areas;
+                if (tracked.trackId > -1) {
+                    contours.push_back(std::move(tracked.contour));
+                    areas.push_back(tracked.record.area);
+                }
+                frame.analysis = FrameAnalysis(frame.image.size(), std::move(contours), std::move(areas));
+            }
+            else {
+                detection.analyze(frame.image, frame.analysis);
+            }
+            detectCounters.busyNanoseconds += elapsedNanoseconds(stageStart);
+            detectCounters.frames++;
+
+            detected.push(frame);
+        }
+
+        detected.finish();
+    });
+
+    std::thread annotateThread([&]() {
+        ObjectDetection annotator;
+        StreamFrame frame;
+
+        while (detected.pop(frame)) {
+            // Drawing is only needed when the frames are written out
+            if (!output.empty()) {
+                auto stageStart = std::chrono::high_resolution_clock::now();
+                annotator.centerObjectInfo(frame.image, frame.analysis);
+                annotateCounters.busyNanoseconds += elapsedNanoseconds(stageStart);
+            }
+            annotateCounters.frames++;
+
+            annotated.push(frame);
+        }
+
+        annotated.finish();
+    });
+
+    std::thread encodeThread([&]() {
+        cv::VideoWriter writer;
+        StreamFrame frame;
+
+        while (annotated.pop(frame)) {
+            // Keep draining after a failure so the upstream stages can finish
+            if (output.empty() || outputFailed) {
+                continue;
+            }
+
+            auto stageStart = std::chrono::high_resolution_clock::now();
+            if (!writer.isOpened()) {
+                writer.open(output, options.fourcc, fps, frame.image.size());
+                if (!writer.isOpened()) {
+                    outputFailed = true;
+                    stopRequested = true;
+                    continue;
+                }
+            }
+            writer.write(frame.image);
+            encodeCounters.busyNanoseconds += elapsedNanoseconds(stageStart);
+            encodeCounters.frames++;
+        }
+    });
+
+    decodeThread.join();
+    detectThread.join();
+    annotateThread.join();
+    encodeThread.join();
+
+    wallSeconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+
+    if (outputFailed) {
+        std::cerr << "Error: Could not open the output video." << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+std::vector<StageStatistics> VideoPipeline::getStatistics() const {
+    std::vector<StageStatistics> statistics;
+
+    const std::pair<const char*, const StageCounters*> stages[] = {
+        { "decode", &decodeCounters },
+        { "detect", &detectCounters },
+        { "annotate", &annotateCounters },
+        { "encode", &encodeCounters }
+    };
+
+    for (const auto& stage : stages) {
+        StageStatistics stats;
+        stats.name = stage.first;
+        stats.frames = stage.second->frames;
+        stats.dropped = stage.second->dropped;
+        stats.busySeconds = stage.second->busyNanoseconds / 1e9;
+        stats.framesPerSecond = wallSeconds > 0 ? stats.frames / wallSeconds : 0;
+        statistics.push_back(stats);
+    }
+
+    return statistics;
+}
@@ -0,0 +1,67 @@
+#ifndef VIDEOPIPELINE_HPP
+#define VIDEOPIPELINE_HPP
+
+#include <opencv2/opencv.hpp>
+#include <atomic>
+#include <string>
+#include <vector>
+#include "FrameAnalysis.hpp"
+using namespace cv;
+
+struct VideoPipelineOptions {
+    // Frames each queue between two stages can hold
+    size_t queueCapacity = 4;
+
+    // Drop newly decoded frames while detection is behind instead of slowing down the source
+    bool dropFrames = false;
+
+    // Follow the center object with ObjectDetection::trackCenterObject instead of analyzing every whole frame;
+    // the analysis passed on to annotation then holds only the tracked object
+    bool track = false;
+
+    // Codec of the output file, only used when an output path is given
+    int fourcc = cv::VideoWriter::fourcc('m', 'p', '4', 'v');
+};
+
+struct StageStatistics {
+    std::string name;
+    uint64_t frames;
+    uint64_t dropped;
+    double busySeconds;
+    double framesPerSecond;
+};
+
+// Runs centerObjectInfo-style detection on a video file or camera with decode, detect,
+// annotate and encode on their own threads, connected by bounded lock-free queues.
+// A stage waiting on a full or empty queue yields briefly and then sleeps until it can go on.
+class VideoPipeline {
+public:
+    explicit VideoPipeline(const VideoPipelineOptions& options = VideoPipelineOptions());
+
+    // Processes the source until it ends. A source made of digits opens that camera index.
+    // An empty output path skips encoding. Returns false when source or output cannot be opened.
+    bool run(const std::string& source, const std::string& output);
+
+    // Asks a running pipeline to stop decoding; frames already queued are still finished
+    void stop();
+
+    // Per-stage counters of the last run
+    std::vector<StageStatistics> getStatistics() const;
+
+private:
+    struct StageCounters {
+        std::atomic<uint64_t> frames{ 0 };
+        std::atomic<uint64_t> dropped{ 0 };
+        std::atomic<int64_t> busyNanoseconds{ 0 };
+    };
+
+    VideoPipelineOptions options;
+    StageCounters decodeCounters;
+    StageCounters detectCounters;
+    StageCounters annotateCounters;
+    StageCounters encodeCounters;
+    std::atomic<bool> stopRequested{ false };
+    double wallSeconds = 0;
+};
+
+#endif // VIDEOPIPELINE_HPP
\ No newline at end of file
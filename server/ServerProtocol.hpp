@@ -0,0 +1,92 @@
+#ifndef SERVERPROTOCOL_HPP
+#define SERVERPROTOCOL_HPP
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <sys/socket.h>
+#include <unistd.h>
+
+// Messages exchanged with the detection server over its Unix domain socket, in native byte order.
+//
+// Request:  RequestHeader, then payloadBytes of image path (no terminator) or encoded image file bytes.
+// Response: ResponseHeader, then bodyBytes of JSON lines in the ResultWriter format: one image line
+//           whose "image" is the request id, followed by one object line per result.
+//
+// A client may send several requests before reading the responses; they can come back in any order.
+
+enum class ServerQuery : uint8_t {
+    // Object closest to the image center
+    CenterObject = 1,
+    // Object containing the point x, y
+    ObjectAt = 2,
+    // Every object with its area, centroid and box
+    Objects = 3
+};
+
+enum class ServerPayload : uint8_t {
+    Path = 1,
+    EncodedImage = 2
+};
+
+enum class ServerStatus : int32_t {
+    Ok = 0,
+    BadRequest = 1,
+    // The path could not be read or the bytes could not be decoded
+    ImageNotRead = 2
+};
+
+struct RequestHeader {
+    uint32_t requestId;
+    uint8_t query;
+    uint8_t payload;
+    uint16_t reserved;
+    int32_t x;
+    int32_t y;
+    uint32_t payloadBytes;
+};
+
+struct ResponseHeader {
+    uint32_t requestId;
+    int32_t status;
+    uint32_t bodyBytes;
+};
+
+// Larger requests are refused and the connection is closed
+const uint32_t maxPayloadBytes = 64u << 20;
+
+// Reads exactly bytes; false on error or when the peer closed the connection first
+inline bool readFully(int fd, void* data, size_t bytes) {
+    char* position = static_cast<char*>(data);
+    while (bytes > 0) {
+        ssize_t count = ::recv(fd, position, bytes, 0);
+        if (count < 0 && errno == EINTR) {
+            continue;
+        }
+        if (count <= 0) {
+            return false;
+        }
+        position += count;
+        bytes -= static_cast<size_t>(count);
+    }
+    return true;
+}
+
+// Writes exactly bytes without raising SIGPIPE when the peer is gone
+inline bool writeFully(int fd, const void* data, size_t bytes) {
+    const char* position = static_cast<const char*>(data);
+    while (bytes > 0) {
+        ssize_t count = ::send(fd, position, bytes, MSG_NOSIGNAL);
+        if (count < 0 && errno == EINTR) {
+            continue;
+        }
+        if (count <= 0) {
+            return false;
+        }
+        position += count;
+        bytes -= static_cast<size_t>(count);
+    }
+    return true;
+}
+
+#endif // SERVERPROTOCOL_HPP
@@ -0,0 +1,161 @@
+#include <iostream>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+#include <cstring>
+#include <cstdlib>
+#include <chrono>
+#include <thread>
+#include <atomic>
+#include <algorithm>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "ServerProtocol.hpp"
+
+// Load generator for the detection server: several connections each send one request, wait for its
+// response and send the next, so the server sees as many concurrent requests as there are connections.
+// The image is sent as a path (the server reads it) or with --bytes as the encoded file contents.
+//
+// Usage: loadgen <socket path> <image> [--connections <n>] [--requests <per connection>]
+//                [--query center | point <x> <y> | objects] [--bytes]
+// Output: connections,requests,errors,seconds,requests_per_second,p50_ms,p99_ms
+
+static int connectTo(const std::string& socketPath) {
+    sockaddr_un address = {};
+    address.sun_family = AF_UNIX;
+    if (socketPath.size() >= sizeof(address.sun_path)) {
+        return -1;
+    }
+    std::strcpy(address.sun_path, socketPath.c_str());
+
+    int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd >= 0 && ::connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+        ::close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        std::cerr << "Usage: loadgen <socket path> <image> [--connections <n>] [--requests <per connection>] "
+            << "[--query center | point <x> <y> | objects] [--bytes]" << std::endl;
+        return 1;
+    }
+
+    std::string socketPath = argv[1];
+    std::string imagePath = argv[2];
+    int connections = 8;
+    int requestsPerConnection = 200;
+    bool sendBytes = false;
+    RequestHeader request = {};
+    request.query = static_cast<uint8_t>(ServerQuery::CenterObject);
+
+    for (int i = 3; i < argc; i++) {
+        if (std::strcmp(argv[i], "--connections") == 0 && i + 1 < argc) {
+            connections = std::max(1, std::atoi(argv[++i]));
+        }
+        else if (std::strcmp(argv[i], "--requests") == 0 && i + 1 < argc) {
+            requestsPerConnection = std::max(1, std::atoi(argv[++i]));
+        }
+        else if (std::strcmp(argv[i], "--bytes") == 0) {
+            sendBytes = true;
+        }
+        else if (std::strcmp(argv[i], "--query") == 0 && i + 1 < argc) {
+            std::string query = argv[++i];
+            if (query == "point" && i + 2 < argc) {
+                request.query = static_cast<uint8_t>(ServerQuery::ObjectAt);
+                request.x = std::atoi(argv[++i]);
+                request.y = std::atoi(argv[++i]);
+            }
+            else if (query == "objects") {
+                request.query = static_cast<uint8_t>(ServerQuery::Objects);
+            }
+        }
+    }
+
+    std::vector<char> payload;
+    if (sendBytes) {
+        std::ifstream file(imagePath, std::ios::binary);
+        if (!file.is_open()) {
+            std::cerr << "Error: Could not read the image." << std::endl;
+            return 1;
+        }
+        payload.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        request.payload = static_cast<uint8_t>(ServerPayload::EncodedImage);
+    }
+    else {
+        payload.assign(imagePath.begin(), imagePath.end());
+        request.payload = static_cast<uint8_t>(ServerPayload::Path);
+    }
+    request.payloadBytes = static_cast<uint32_t>(payload.size());
+
+    // Latencies in nanoseconds, one slice per connection
+    std::vector<int64_t> latencies(static_cast<size_t>(connections) * requestsPerConnection, -1);
+    std::atomic<int> errors(0);
+
+    auto start = std::chrono::steady_clock::now();
+
+    std::vector<std::thread> clients;
+    for (int client = 0; client < connections; client++) {
+        clients.emplace_back([&, client]() {
+            int fd = connectTo(socketPath);
+            if (fd < 0) {
+                errors += requestsPerConnection;
+                return;
+            }
+
+            std::vector<char> body;
+            for (int i = 0; i < requestsPerConnection; i++) {
+                RequestHeader header = request;
+                header.requestId = static_cast<uint32_t>(client * requestsPerConnection + i);
+
+                auto sent = std::chrono::steady_clock::now();
+                ResponseHeader response;
+                if (!writeFully(fd, &header, sizeof(header)) || !writeFully(fd, payload.data(), payload.size())
+                    || !readFully(fd, &response, sizeof(response))) {
+                    errors += requestsPerConnection - i;
+                    break;
+                }
+                body.resize(response.bodyBytes);
+                if (!readFully(fd, body.data(), body.size())) {
+                    errors += requestsPerConnection - i;
+                    break;
+                }
+
+                if (response.requestId != header.requestId || response.status != static_cast<int32_t>(ServerStatus::Ok)) {
+                    errors++;
+                    continue;
+                }
+                latencies[header.requestId] = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - sent).count();
+            }
+
+            ::close(fd);
+        });
+    }
+
+    for (std::thread& client : clients) {
+        client.join();
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    latencies.erase(std::remove(latencies.begin(), latencies.end(), -1), latencies.end());
+    std::sort(latencies.begin(), latencies.end());
+
+    auto percentileMs = [&](double percentile) {
+        if (latencies.empty()) {
+            return 0.0;
+        }
+        size_t index = std::min(latencies.size() - 1, static_cast<size_t>(percentile * latencies.size()));
+        return latencies[index] / 1e6;
+    };
+
+    std::cout << "connections,requests,errors,seconds,requests_per_second,p50_ms,p99_ms" << std::endl;
+    std::cout << connections << "," << latencies.size() << "," << errors << "," << seconds << ","
+        << (seconds > 0 ? latencies.size() / seconds : 0) << "," << percentileMs(0.50) << "," << percentileMs(0.99) << std::endl;
+
+    return errors == 0 ? 0 : 1;
+}
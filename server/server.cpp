@@ -0,0 +1,340 @@
+#include <opencv2/opencv.hpp>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <cstring>
+#include <cstdlib>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <list>
+#include <memory>
+#include <atomic>
+#include <csignal>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "../main/ObjectDetection.hpp"
+#include "../main/ResultWriter.hpp"
+#include "ServerProtocol.hpp"
+using namespace cv;
+
+// Resident detection server: answers center, point and object queries on images sent over a Unix
+// domain socket, so clients pay neither process start-up nor OpenCV initialisation per image.
+// Requests arriving together are gathered into micro-batches of up to --batch requests, waiting at
+// most --window microseconds for the batch to fill, and each batch is decoded and queried in parallel
+// on OpenCV's thread pool through the reentrant ObjectDetection queries, whose per-thread scratch
+// buffers stay warm from batch to batch. See ServerProtocol.hpp for the message format.
+//
+// Usage: server <socket path> [--batch <requests>] [--window <microseconds>] [--pending <requests>]
+//
+// At most --pending requests (default 4 batches) and 256 MiB of payload wait for a worker; beyond
+// that the server stops reading from the sockets until a batch is taken.
+//
+// Runs until SIGINT or SIGTERM, then answers the requests already received and removes the socket.
+
+// Payload bytes kept queued before the server stops reading from clients
+static const size_t maxPendingBytes = size_t(256) << 20;
+
+static std::atomic<bool> stopRequested(false);
+
+static void handleStopSignal(int) {
+    stopRequested = true;
+}
+
+// One client; the socket is closed when the reader and every pending request have let go of it
+struct Connection {
+    explicit Connection(int fd) : fd(fd) {
+    }
+
+    ~Connection() {
+        ::close(fd);
+    }
+
+    // Responses of one connection come from several workers, so writes are serialized
+    void respond(uint32_t requestId, ServerStatus status, const std::string& body) {
+        ResponseHeader header;
+        header.requestId = requestId;
+        header.status = static_cast<int32_t>(status);
+        header.bodyBytes = static_cast<uint32_t>(body.size());
+
+        std::lock_guard<std::mutex> lock(writeMutex);
+        if (writeFully(fd, &header, sizeof(header))) {
+            writeFully(fd, body.data(), body.size());
+        }
+    }
+
+    int fd;
+    std::mutex writeMutex;
+    std::atomic<bool> closed{ false };
+};
+
+struct ServerRequest {
+    std::shared_ptr<Connection> connection;
+    RequestHeader header;
+    std::vector<char> payload;
+};
+
+// Pending requests are bounded by count and by payload bytes. When either bound is reached, push
+// blocks the connection's reader, so clients that send faster than the server answers are slowed
+// down by the socket instead of growing the queue.
+class RequestBatcher {
+public:
+    RequestBatcher(size_t maxBatch, std::chrono::microseconds window, size_t maxPending, size_t maxPendingBytes)
+        : maxBatch(maxBatch), window(window), maxPending(maxPending), maxPendingBytes(maxPendingBytes) {
+    }
+
+    void push(ServerRequest&& request) {
+        {
+            // A single request larger than the byte bound is still let through once the queue is empty
+            std::unique_lock<std::mutex> lock(mutex);
+            space.wait(lock, [&]() {
+                return pending.empty() || (pending.size() < maxPending && pendingBytes + request.payload.size() <= maxPendingBytes);
+            });
+            pendingBytes += request.payload.size();
+            pending.push_back(std::move(request));
+        }
+        ready.notify_one();
+    }
+
+    // Waits for a request, then up to the window for the batch to fill.
+    // Returns false once finish was called and nothing is pending.
+    bool take(std::vector<ServerRequest>& batch) {
+        batch.clear();
+
+        std::unique_lock<std::mutex> lock(mutex);
+        ready.wait(lock, [&]() { return !pending.empty() || finished; });
+        if (pending.empty()) {
+            return false;
+        }
+
+        ready.wait_for(lock, window, [&]() { return pending.size() >= maxBatch || finished; });
+
+        size_t count = std::min(pending.size(), maxBatch);
+        for (size_t i = 0; i < count; i++) {
+            pendingBytes -= pending.front().payload.size();
+            batch.push_back(std::move(pending.front()));
+            pending.pop_front();
+        }
+        lock.unlock();
+
+        space.notify_all();
+        return true;
+    }
+
+    void finish() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            finished = true;
+        }
+        ready.notify_all();
+    }
+
+private:
+    size_t maxBatch;
+    std::chrono::microseconds window;
+    size_t maxPending;
+    size_t maxPendingBytes;
+    std::mutex mutex;
+    std::condition_variable ready;
+    std::condition_variable space;
+    std::deque<ServerRequest> pending;
+    size_t pendingBytes = 0;
+    bool finished = false;
+};
+
+static bool isValidRequest(const RequestHeader& header) {
+    bool knownQuery = header.query >= static_cast<uint8_t>(ServerQuery::CenterObject) && header.query <= static_cast<uint8_t>(ServerQuery::Objects);
+    bool knownPayload = header.payload == static_cast<uint8_t>(ServerPayload::Path) || header.payload == static_cast<uint8_t>(ServerPayload::EncodedImage);
+
+    return knownQuery && knownPayload && header.payloadBytes > 0;
+}
+
+static void readRequests(std::shared_ptr<Connection> connection, RequestBatcher& batcher) {
+    while (true) {
+        ServerRequest request;
+        if (!readFully(connection->fd, &request.header, sizeof(request.header))) {
+            break;
+        }
+
+        // A payload this large cannot be skipped safely, so the stream is out of sync from here on
+        if (request.header.payloadBytes > maxPayloadBytes) {
+            connection->respond(request.header.requestId, ServerStatus::BadRequest, "{\"error\":\"payload too large\"}\n");
+            break;
+        }
+
+        request.payload.resize(request.header.payloadBytes);
+        if (!readFully(connection->fd, request.payload.data(), request.payload.size())) {
+            break;
+        }
+
+        if (!isValidRequest(request.header)) {
+            connection->respond(request.header.requestId, ServerStatus::BadRequest, "{\"error\":\"unknown query or payload\"}\n");
+            continue;
+        }
+
+        request.connection = connection;
+        batcher.push(std::move(request));
+    }
+
+    connection->closed = true;
+}
+
+static void answer(const ObjectDetection& detection, const ServerRequest& request) {
+    const RequestHeader& header = request.header;
+
+    cv::Mat image;
+    std::string path;
+    if (header.payload == static_cast<uint8_t>(ServerPayload::Path)) {
+        path.assign(request.payload.begin(), request.payload.end());
+        image = cv::imread(path, cv::IMREAD_COLOR);
+    }
+    else {
+        cv::Mat encoded(1, static_cast<int>(request.payload.size()), CV_8UC1, const_cast<char*>(request.payload.data()));
+        image = cv::imdecode(encoded, cv::IMREAD_COLOR);
+    }
+
+    std::ostringstream body;
+    {
+        ResultWriter writer(body, ResultFormat::JsonLines, 4096);
+
+        if (image.empty()) {
+            writer.writeImage(header.requestId, path, false, 0);
+        }
+        else if (header.query == static_cast<uint8_t>(ServerQuery::Objects)) {
+            FrameAnalysis analysis = detection.detect(image);
+            writer.writeImage(header.requestId, path, true, static_cast<int>(analysis.getObjectCount()));
+            writer.writeObjects(analysis, header.requestId);
+        }
+        else {
+            // A point outside the image has no object, like a point on the background
+            cv::Point point(header.x, header.y);
+            ObjectRecord record;
+            if (header.query == static_cast<uint8_t>(ServerQuery::CenterObject)) {
+                record = detection.queryCenterObject(image);
+            }
+            else if (cv::Rect(0, 0, image.cols, image.rows).contains(point)) {
+                record = detection.queryObjectAt(image, point);
+            }
+            else {
+                record = FrameAnalysis().getRecord(-1, 0);
+            }
+            record.imageId = header.requestId;
+
+            writer.writeImage(header.requestId, path, true, record.objectId > -1 ? 1 : 0);
+            if (record.objectId > -1) {
+                writer.writeObject(record);
+            }
+        }
+    }
+
+    request.connection->respond(header.requestId, image.empty() ? ServerStatus::ImageNotRead : ServerStatus::Ok, body.str());
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::cerr << "Usage: server <socket path> [--batch <requests>] [--window <microseconds>] [--pending <requests>]" << std::endl;
+        return 1;
+    }
+
+    std::string socketPath = argv[1];
+    size_t maxBatch = 16;
+    long windowMicroseconds = 200;
+    size_t maxPending = 0;
+    for (int i = 2; i + 1 < argc; i += 2) {
+        if (std::strcmp(argv[i], "--batch") == 0) {
+            maxBatch = static_cast<size_t>(std::max(1, std::atoi(argv[i + 1])));
+        }
+        else if (std::strcmp(argv[i], "--window") == 0) {
+            windowMicroseconds = std::max(0L, std::atol(argv[i + 1]));
+        }
+        else if (std::strcmp(argv[i], "--pending") == 0) {
+            maxPending = static_cast<size_t>(std::max(1, std::atoi(argv[i + 1])));
+        }
+    }
+
+    sockaddr_un address = {};
+    address.sun_family = AF_UNIX;
+    if (socketPath.size() >= sizeof(address.sun_path)) {
+        std::cerr << "Error: Socket path is too long." << std::endl;
+        return 1;
+    }
+    std::strcpy(address.sun_path, socketPath.c_str());
+
+    int listenFd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    ::unlink(socketPath.c_str());
+    if (listenFd < 0 || ::bind(listenFd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 || ::listen(listenFd, 64) != 0) {
+        std::cerr << "Error: Could not listen on the socket." << std::endl;
+        return 1;
+    }
+
+    std::signal(SIGINT, handleStopSignal);
+    std::signal(SIGTERM, handleStopSignal);
+    std::signal(SIGPIPE, SIG_IGN);
+
+    // One instance for every request: the const queries keep their scratch buffers per thread
+    const ObjectDetection detection;
+    if (maxPending == 0) {
+        maxPending = 4 * maxBatch;
+    }
+    RequestBatcher batcher(maxBatch, std::chrono::microseconds(windowMicroseconds), std::max(maxPending, maxBatch), maxPendingBytes);
+    size_t batchCount = 0;
+    size_t requestCount = 0;
+
+    std::thread dispatchThread([&]() {
+        std::vector<ServerRequest> batch;
+        while (batcher.take(batch)) {
+            cv::parallel_for_(cv::Range(0, static_cast<int>(batch.size())), [&](const cv::Range& range) {
+                for (int i = range.start; i < range.end; i++) {
+                    answer(detection, batch[i]);
+                }
+            });
+            batchCount++;
+            requestCount += batch.size();
+        }
+    });
+
+    std::list<std::pair<std::shared_ptr<Connection>, std::thread>> clients;
+    std::cerr << "Listening on " << socketPath << std::endl;
+
+    while (!stopRequested) {
+        pollfd listener = { listenFd, POLLIN, 0 };
+        if (::poll(&listener, 1, 200) > 0) {
+            int clientFd = ::accept(listenFd, nullptr, nullptr);
+            if (clientFd >= 0) {
+                auto connection = std::make_shared<Connection>(clientFd);
+                clients.emplace_back(connection, std::thread(readRequests, connection, std::ref(batcher)));
+            }
+        }
+
+        // Join the readers of clients that disconnected
+        for (auto it = clients.begin(); it != clients.end();) {
+            if (it->first->closed) {
+                it->second.join();
+                it = clients.erase(it);
+            }
+            else {
+                ++it;
+            }
+        }
+    }
+
+    ::close(listenFd);
+    ::unlink(socketPath.c_str());
+
+    // Stop reading new requests, then answer the ones already queued
+    for (auto& client : clients) {
+        ::shutdown(client.first->fd, SHUT_RD);
+        client.second.join();
+    }
+    batcher.finish();
+    dispatchThread.join();
+
+    std::cerr << requestCount << " requests in " << batchCount << " batches" << std::endl;
+
+    return 0;
+}
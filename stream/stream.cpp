@@ -0,0 +1,61 @@
+#include <opencv2/opencv.hpp>
+#include <iostream>
+#include <string>
+#include <cstring>
+#include "../main/Tracing.hpp"
+#include "../main/VideoPipeline.hpp"
+using namespace cv;
+
+// Streaming runner: finds the center object in every frame of a video file or camera,
+// with decoding, detection, annotation and encoding running on separate threads.
+//
+// Usage: stream <video | camera index> [output video] [--drop] [--track] [--trace <prefix>]
+//
+// --trace writes <prefix>.json (Chrome trace) and <prefix>.prom (Prometheus metrics) at the end;
+// they only hold data when built with OBJECTDETECTION_TRACING.
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::cerr << "Usage: stream <video | camera index> [output video] [--drop] [--track] [--trace <prefix>]" << std::endl;
+        return 1;
+    }
+
+    VideoPipelineOptions options;
+    std::string output;
+    std::string tracePrefix;
+    for (int i = 2; i < argc; i++) {
+        if (std::strcmp(argv[i], "--drop") == 0) {
+            options.dropFrames = true;
+        }
+        else if (std::strcmp(argv[i], "--track") == 0) {
+            options.track = true;
+        }
+        else if (std::strcmp(argv[i], "--trace") == 0 && i + 1 < argc) {
+            tracePrefix = argv[++i];
+        }
+        else {
+            output = argv[i];
+        }
+    }
+
+    VideoPipeline pipeline(options);
+    if (!pipeline.run(argv[1], output)) {
+        return 1;
+    }
+
+    for (const StageStatistics& stage : pipeline.getStatistics()) {
+        std::cerr << stage.name << ": " << stage.frames << " frames, " << stage.dropped << " dropped, "
+            << stage.busySeconds << " s busy, " << stage.framesPerSecond << " frames/sec" << std::endl;
+    }
+
+    if (!tracePrefix.empty()) {
+        if (!Tracing::isEnabled()) {
+            std::cerr << "Warning: built without OBJECTDETECTION_TRACING, the trace files are empty." << std::endl;
+        }
+        if (!Tracing::writeChromeTrace(tracePrefix + ".json") || !Tracing::writePrometheus(tracePrefix + ".prom")) {
+            return 1;
+        }
+    }
+
+    return 0;
+}
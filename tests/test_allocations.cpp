@@ -0,0 +1,55 @@
+// Runs analyze and the queries on frames of one size and fails when ObjectDetection's scratch
+// buffers allocate after warm-up. The two frames hold a different number of objects, so the
+// contour and component buffers have to settle at the larger of the two.
+//
+// Build: cmake -S .. -B build && cmake --build build --target test_allocations
+// Run:   ctest --test-dir build -R test_allocations
+
+#include <opencv2/opencv.hpp>
+#include <iostream>
+#include "../main/ObjectDetection.hpp"
+#include "../bench/SyntheticImage.hpp"
+using namespace cv;
+
+int main() {
+    const int warmupFrames = 4;
+    const int frames = 40;
+
+    cv::Mat frameA = createSyntheticImage(1280, 720, 120);
+    cv::Mat frameB = createSyntheticImage(1280, 720, 80);
+    cv::Mat output;
+
+    int failures = 0;
+    for (SegmentationMethod method : { SegmentationMethod::CannyContours, SegmentationMethod::ThresholdComponents }) {
+        ObjectDetection detection;
+        detection.setSegmentationMethod(method);
+        FrameAnalysis analysis;
+
+        auto runFrame = [&](int i) {
+            const cv::Mat& input = (i % 2 == 0) ? frameA : frameB;
+            input.copyTo(output);
+
+            detection.analyze(input, analysis);
+            detection.identifyCenterObject(output, analysis);
+            detection.findObjectArea(analysis, output.cols / 2, output.rows / 2);
+        };
+
+        for (int i = 0; i < warmupFrames; i++) {
+            runFrame(i);
+        }
+        size_t allocationsAfterWarmup = detection.getAllocationCount();
+
+        for (int i = 0; i < frames; i++) {
+            runFrame(i);
+        }
+
+        size_t allocations = detection.getAllocationCount() - allocationsAfterWarmup;
+        if (allocations != 0) {
+            std::cerr << "Error: " << allocations << " allocations in " << frames << " frames after warm-up with segmentation method "
+                << static_cast<int>(method) << std::endl;
+            failures++;
+        }
+    }
+
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,119 @@
+// Stress test of the reentrant ObjectDetection queries: eight threads share one const instance and
+// two images, mixing center, point, multi-point and full detection queries, and every answer must
+// match a single-threaded run. The images must be left unchanged.
+//
+// Build: cmake -S .. -B build && cmake --build build --target test_concurrency
+// Run:   ctest --test-dir build -R test_concurrency
+
+#include <opencv2/opencv.hpp>
+#include <atomic>
+#include <iostream>
+#include <thread>
+#include <vector>
+#include "../main/ObjectDetection.hpp"
+#include "../bench/SyntheticImage.hpp"
+using namespace cv;
+
+static bool sameRecord(const ObjectRecord& a, const ObjectRecord& b) {
+    return a.objectId == b.objectId && a.area == b.area && a.centroidX == b.centroidX && a.centroidY == b.centroidY
+        && a.boxX == b.boxX && a.boxY == b.boxY && a.boxWidth == b.boxWidth && a.boxHeight == b.boxHeight;
+}
+
+static bool sameResults(const std::vector<PointQueryResult>& a, const std::vector<PointQueryResult>& b) {
+    if (a.size() != b.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < a.size(); i++) {
+        if (a[i].objectId != b[i].objectId || a[i].area != b[i].area || a[i].centroid != b[i].centroid) {
+            return false;
+        }
+    }
+    return true;
+}
+
+struct Expected {
+    ObjectRecord center;
+    std::vector<ObjectRecord> points;
+    std::vector<PointQueryResult> objects;
+    int objectCount;
+};
+
+int main() {
+    const int threadCount = 8;
+    const int queries = 60;
+
+    // Threads are the unit of parallelism here, so OpenCV must not add its own pool on top
+    cv::setNumThreads(1);
+
+    const std::vector<cv::Mat> images = { createSyntheticImage(1280, 720, 120), createNestedImage(1280, 720, 200) };
+    std::vector<double> checksums;
+    for (const cv::Mat& image : images) {
+        checksums.push_back(cv::sum(image)[0]);
+    }
+
+    std::vector<cv::Point> points;
+    for (int i = 0; i < 32; i++) {
+        points.push_back(cv::Point(60 + (i % 8) * 150, 60 + (i / 8) * 170));
+    }
+
+    const ObjectDetection detection;
+    std::vector<Expected> expected(images.size());
+    for (size_t i = 0; i < images.size(); i++) {
+        expected[i].center = detection.queryCenterObject(images[i]);
+        for (const cv::Point& point : points) {
+            expected[i].points.push_back(detection.queryObjectAt(images[i], point));
+        }
+        expected[i].objects = detection.queryObjects(images[i], points);
+        expected[i].objectCount = detection.detect(images[i]).getObjectCount();
+    }
+
+    std::atomic<int> mismatches(0);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < threadCount; t++) {
+        threads.emplace_back([&, t]() {
+            // Each thread renders into its own output, the shared images are only read
+            cv::Mat output;
+            for (int i = 0; i < queries; i++) {
+                size_t imageIndex = (t + i) % images.size();
+                const cv::Mat& image = images[imageIndex];
+                const Expected& answer = expected[imageIndex];
+                size_t p = (t * queries + i) % points.size();
+
+                bool same = true;
+                switch (i % 4) {
+                case 0:
+                    same = sameRecord(detection.queryCenterObject(image, &output), answer.center);
+                    break;
+                case 1:
+                    same = sameRecord(detection.queryObjectAt(image, points[p], &output), answer.points[p]);
+                    break;
+                case 2:
+                    same = sameResults(detection.queryObjects(image, points), answer.objects);
+                    break;
+                default:
+                    same = detection.detect(image).getObjectCount() == answer.objectCount;
+                    break;
+                }
+                if (!same) {
+                    mismatches++;
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    bool unchanged = true;
+    for (size_t i = 0; i < images.size(); i++) {
+        unchanged = unchanged && cv::sum(images[i])[0] == checksums[i];
+    }
+
+    if (mismatches > 0 || !unchanged) {
+        std::cerr << "Error: " << mismatches << " wrong results from " << threadCount << " threads"
+            << (unchanged ? "" : ", and a shared image was changed") << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,89 @@
+// Checks dilateSquare and dilateSquareRows against N iterations of a plain 3x3 maximum and against
+// cv::dilate, on 300 random sparse images of random size and radius: the whole image, random band
+// splits and in place, 900 comparisons in all.
+//
+// Build: cmake -S .. -B build && cmake --build build --target test_max_filter
+// Run:   ctest --test-dir build -R test_max_filter
+
+#include <opencv2/opencv.hpp>
+#include <algorithm>
+#include <iostream>
+#include "../main/MaxFilter.hpp"
+using namespace cv;
+
+// N iterations of the 3x3 maximum, pixels outside the image ignored
+static cv::Mat dilateReference(const cv::Mat& source, int iterations) {
+    cv::Mat current = source.clone();
+    for (int i = 0; i < iterations; i++) {
+        cv::Mat next(current.size(), CV_8UC1);
+        for (int y = 0; y < current.rows; y++) {
+            for (int x = 0; x < current.cols; x++) {
+                uchar value = 0;
+                for (int dy = std::max(y - 1, 0); dy <= std::min(y + 1, current.rows - 1); dy++) {
+                    for (int dx = std::max(x - 1, 0); dx <= std::min(x + 1, current.cols - 1); dx++) {
+                        value = std::max(value, current.at<uchar>(dy, dx));
+                    }
+                }
+                next.at<uchar>(y, x) = value;
+            }
+        }
+        current = next;
+    }
+
+    return current;
+}
+
+static bool same(const cv::Mat& a, const cv::Mat& b) {
+    return a.size() == b.size() && cv::norm(a, b, cv::NORM_INF) == 0;
+}
+
+int main() {
+    cv::RNG rng(2024);
+    int failures = 0;
+
+    for (int test = 0; test < 300; test++) {
+        int rows = rng.uniform(1, 71);
+        int cols = rng.uniform(1, 91);
+        int radius = rng.uniform(0, 9);
+
+        // Sparse like an edge map, with some gray levels so the maximum is not just a union
+        cv::Mat source(rows, cols, CV_8UC1);
+        for (int y = 0; y < rows; y++) {
+            for (int x = 0; x < cols; x++) {
+                source.at<uchar>(y, x) = rng.uniform(0, 40) == 0 ? (rng.uniform(0, 2) == 0 ? 255 : rng.uniform(0, 256)) : 0;
+            }
+        }
+
+        cv::Mat expected = dilateReference(source, radius);
+        cv::Mat dilated;
+        cv::dilate(source, dilated, cv::Mat(), cv::Point(-1, -1), radius);
+        if (!same(expected, dilated)) {
+            std::cerr << "Error: the reference differs from cv::dilate at " << cols << "x" << rows << " with radius " << radius << std::endl;
+            return 1;
+        }
+
+        cv::Mat whole;
+        dilateSquare(source, whole, radius);
+
+        cv::Mat banded(rows, cols, CV_8UC1);
+        int bandRows = rng.uniform(1, 11);
+        for (int top = 0; top < rows; top += bandRows) {
+            int bottom = std::min(top + bandRows, rows);
+            cv::Mat band = banded.rowRange(top, bottom);
+            dilateSquareRows(source, top, bottom, radius, band);
+        }
+
+        cv::Mat inPlace = source.clone();
+        dilateSquare(inPlace, inPlace, radius);
+
+        const std::pair<const char*, const cv::Mat*> results[] = { { "whole", &whole }, { "banded", &banded }, { "in place", &inPlace } };
+        for (const auto& result : results) {
+            if (!same(expected, *result.second)) {
+                std::cerr << "Error: " << result.first << " max filter differs at " << cols << "x" << rows << " with radius " << radius << std::endl;
+                failures++;
+            }
+        }
+    }
+
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,114 @@
+// Checks ObjectIndex against scanning every object, on 300 random frames of rectangular objects whose
+// centroids sit on a coarse grid, so many share an x or y coordinate and some are exact duplicates.
+// Nearest, k-nearest (also with k larger than the object count), rectangle overlap and center-object
+// queries must give the same objects in the same order, ties going to the lower index.
+//
+// Build: cmake -S .. -B build && cmake --build build --target test_object_index
+// Run:   ctest --test-dir build -R test_object_index
+
+#include <opencv2/opencv.hpp>
+#include <algorithm>
+#include <iostream>
+#include <vector>
+#include "../main/FrameAnalysis.hpp"
+#include "../main/ObjectIndex.hpp"
+using namespace cv;
+
+// k nearest by sorting every object, ties to the lower index
+static std::vector<int> scanNearest(const FrameAnalysis& analysis, cv::Point2f point, int k) {
+    std::vector<std::pair<float, int>> distances;
+    for (int i = 0; i < analysis.getObjectCount(); i++) {
+        distances.emplace_back(static_cast<float>(cv::norm(point - analysis.getCentroid(i))), i);
+    }
+    std::sort(distances.begin(), distances.end());
+
+    std::vector<int> nearest;
+    for (size_t i = 0; i < distances.size() && static_cast<int>(i) < k; i++) {
+        nearest.push_back(distances[i].second);
+    }
+    return nearest;
+}
+
+static std::vector<int> scanOverlapping(const FrameAnalysis& analysis, const cv::Rect& rect) {
+    std::vector<int> overlapping;
+    for (int i = 0; i < analysis.getObjectCount(); i++) {
+        if ((analysis.getBoundingBox(i) & rect).area() > 0) {
+            overlapping.push_back(i);
+        }
+    }
+    return overlapping;
+}
+
+// Rectangles with corners on a 10 px grid; about one in five repeats an earlier object exactly
+static FrameAnalysis createFrame(cv::RNG& rng, cv::Size frameSize) {
+    int count = rng.uniform(0, 80);
+    std::vector<std::vector<cv::Point>> contours;
+    std::vector<double> areas;
+
+    for (int i = 0; i < count; i++) {
+        if (!contours.empty() && rng.uniform(0, 5) == 0) {
+            int copy = rng.uniform(0, static_cast<int>(contours.size()));
+            contours.push_back(contours[copy]);
+            areas.push_back(areas[copy]);
+            continue;
+        }
+
+        int x = rng.uniform(0, frameSize.width / 10 - 4) * 10;
+        int y = rng.uniform(0, frameSize.height / 10 - 4) * 10;
+        int width = rng.uniform(1, 4) * 10;
+        int height = rng.uniform(1, 4) * 10;
+        contours.push_back({ cv::Point(x, y), cv::Point(x + width, y), cv::Point(x + width, y + height), cv::Point(x, y + height) });
+        areas.push_back(static_cast<double>(width) * height);
+    }
+
+    return FrameAnalysis(frameSize, std::move(contours), std::move(areas));
+}
+
+int main() {
+    cv::RNG rng(2024);
+    int failures = 0;
+
+    for (int trial = 0; trial < 300 && failures < 10; trial++) {
+        cv::Size frameSize(rng.uniform(8, 30) * 10, rng.uniform(8, 30) * 10);
+        FrameAnalysis analysis = createFrame(rng, frameSize);
+        ObjectIndex index(analysis);
+        int count = analysis.getObjectCount();
+
+        if (index.size() != static_cast<size_t>(count)) {
+            std::cerr << "Error: trial " << trial << ": index has " << index.size() << " objects instead of " << count << std::endl;
+            failures++;
+            continue;
+        }
+        if (index.findCenterObject() != analysis.findCenterObject()) {
+            std::cerr << "Error: trial " << trial << ": center object " << index.findCenterObject() << " instead of " << analysis.findCenterObject() << std::endl;
+            failures++;
+        }
+
+        for (int query = 0; query < 100; query++) {
+            // Half the points on the grid, where distances and split coordinates tie most often
+            cv::Point2f point = query % 2 == 0
+                ? cv::Point2f(static_cast<float>(rng.uniform(0, frameSize.width / 5) * 5), static_cast<float>(rng.uniform(0, frameSize.height / 5) * 5))
+                : cv::Point2f(rng.uniform(0.f, static_cast<float>(frameSize.width)), rng.uniform(0.f, static_cast<float>(frameSize.height)));
+            int k = rng.uniform(1, count + 6);
+
+            std::vector<int> expected = scanNearest(analysis, point, k);
+            if (index.findNearest(point, k) != expected) {
+                std::cerr << "Error: trial " << trial << ": " << k << " nearest to " << point.x << "," << point.y << " differ" << std::endl;
+                failures++;
+            }
+            if (index.findNearest(point) != (expected.empty() ? -1 : expected[0])) {
+                std::cerr << "Error: trial " << trial << ": nearest to " << point.x << "," << point.y << " differs" << std::endl;
+                failures++;
+            }
+
+            cv::Rect rect(rng.uniform(-20, frameSize.width), rng.uniform(-20, frameSize.height), rng.uniform(0, 80), rng.uniform(0, 80));
+            if (index.findOverlapping(rect) != scanOverlapping(analysis, rect)) {
+                std::cerr << "Error: trial " << trial << ": objects overlapping " << rect.x << "," << rect.y << " "
+                    << rect.width << "x" << rect.height << " differ" << std::endl;
+                failures++;
+            }
+        }
+    }
+
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,59 @@
+// Checks that the point queries taking an image answer like a full-frame analyze, on cells whose
+// nucleus outline lies inside the cell's and on cells that touch, for clicks on the nucleus, the
+// cell body, the point where two cells touch and the background.
+//
+// Build: cmake -S .. -B build && cmake --build build --target test_point_queries
+// Run:   ctest --test-dir build -R test_point_queries
+
+#include <opencv2/opencv.hpp>
+#include <iostream>
+#include <vector>
+#include "../main/ObjectDetection.hpp"
+#include "../bench/SyntheticImage.hpp"
+using namespace cv;
+
+int main() {
+    const int spacing = 200;
+    const int radius = spacing * 2 / 5;
+    const cv::Mat image = createNestedImage(1600, 1000, spacing);
+
+    // Nucleus, cell body, the touching point of the first pair, and the gap between pairs
+    cv::Point center(spacing / 2, spacing / 2);
+    std::vector<cv::Point> points = {
+        center,
+        center + cv::Point(radius * 3 / 4, 0),
+        center + cv::Point(radius, 0),
+        center + cv::Point(0, spacing / 2),
+        cv::Point(image.cols / 2, image.rows / 2)
+    };
+
+    int failures = 0;
+    for (SegmentationMethod method : { SegmentationMethod::CannyContours, SegmentationMethod::ThresholdComponents }) {
+        ObjectDetection detection;
+        detection.setSegmentationMethod(method);
+        FrameAnalysis analysis = detection.analyze(image);
+
+        for (const cv::Point& point : points) {
+            int expected = detection.findObjectArea(analysis, point.x, point.y);
+
+            cv::Mat copy = image.clone();
+            int area = detection.findObjectArea(copy, point.x, point.y);
+
+            // getArea keeps the last object found, so each point gets a fresh instance
+            ObjectDetection info;
+            info.setSegmentationMethod(method);
+            info.findObjectInfo(copy, point.x, point.y);
+            int infoArea = static_cast<int>(info.getArea());
+            ObjectRecord record = detection.queryObjectAt(image, point);
+            int queryArea = record.objectId > -1 ? static_cast<int>(record.area) : 0;
+
+            if (area != expected || infoArea != expected || queryArea != expected) {
+                std::cerr << "Error: point " << point.x << "," << point.y << " with segmentation method " << static_cast<int>(method) << ": full frame "
+                    << expected << ", findObjectArea " << area << ", findObjectInfo " << infoArea << ", queryObjectAt " << queryArea << std::endl;
+                failures++;
+            }
+        }
+    }
+
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,94 @@
+// Compares TiledDetection with a full-frame ObjectDetection::analyze on crowded touching discs and on
+// large cells with a nucleus, both crossing many tile borders. Both paths must find the same objects
+// with the same areas and centroids, up to their order, without a stitching region larger than
+// maxStitchTiles tiles. A disc spanning many more tiles than that must be reported as oversized and be
+// the only object missing from the tiled result.
+//
+// Build: cmake -S .. -B build && cmake --build build --target test_tiled
+// Run:   ctest --test-dir build -R test_tiled
+
+#include <opencv2/opencv.hpp>
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <tuple>
+#include <vector>
+#include "../main/ObjectDetection.hpp"
+#include "../main/TiledDetection.hpp"
+#include "../bench/SyntheticImage.hpp"
+using namespace cv;
+
+static std::vector<std::tuple<double, float, float>> getObjects(const FrameAnalysis& analysis) {
+    std::vector<std::tuple<double, float, float>> objects;
+    for (int i = 0; i < analysis.getObjectCount(); i++) {
+        cv::Point2f centroid = analysis.getCentroid(i);
+        objects.push_back(std::make_tuple(analysis.getArea(i), centroid.x, centroid.y));
+    }
+    std::sort(objects.begin(), objects.end());
+
+    return objects;
+}
+
+// oversized is the number of objects too large to stitch, expected to be the largest of the full frame
+static bool sameObjects(const std::string& name, const cv::Mat& image, int tileSize, int oversized) {
+    ObjectDetection detection;
+    FrameAnalysis full = detection.analyze(image);
+    std::vector<std::tuple<double, float, float>> expected = getObjects(full);
+    std::sort(expected.begin(), expected.end(), [](const std::tuple<double, float, float>& a, const std::tuple<double, float, float>& b) {
+        return std::get<0>(a) > std::get<0>(b);
+    });
+    expected.erase(expected.begin(), expected.begin() + std::min(static_cast<size_t>(oversized), expected.size()));
+    std::sort(expected.begin(), expected.end());
+
+    TiledDetection tiled;
+    tiled.tileSize = tileSize;
+    MatTileSource source(image);
+    std::vector<std::tuple<double, float, float>> objects = getObjects(tiled.analyze(source));
+
+    int maxSide = tiled.maxStitchTiles * tileSize;
+    cv::Size largest = tiled.getLargestRegion();
+    if (largest.width > maxSide || largest.height > maxSide) {
+        std::cerr << "Error: " << name << ": traced a " << largest.width << "x" << largest.height
+            << " region, more than " << maxSide << " pixels" << std::endl;
+        return false;
+    }
+    if (tiled.getOversizedCount() != oversized) {
+        std::cerr << "Error: " << name << ": " << tiled.getOversizedCount() << " oversized objects instead of "
+            << oversized << std::endl;
+        return false;
+    }
+
+    bool same = expected.size() == objects.size();
+    for (size_t i = 0; same && i < objects.size(); i++) {
+        same = std::abs(std::get<0>(expected[i]) - std::get<0>(objects[i])) < 1e-6
+            && std::abs(std::get<1>(expected[i]) - std::get<1>(objects[i])) < 1e-3
+            && std::abs(std::get<2>(expected[i]) - std::get<2>(objects[i])) < 1e-3;
+    }
+
+    if (!same) {
+        std::cerr << "Error: " << name << ": full frame found " << expected.size() << " objects, " << tiled.getTileCount()
+            << " tiles found " << objects.size() << " with " << tiled.getStitchedCount() << " stitched" << std::endl;
+    }
+    return same;
+}
+
+int main() {
+    int failures = 0;
+
+    if (!sameObjects("dense", createDenseImage(3000, 2000, 80), 512, 0)) {
+        failures++;
+    }
+    if (!sameObjects("nested", createNestedImage(3000, 2000, 300), 512, 0)) {
+        failures++;
+    }
+
+    // A disc across about five by five tiles, merged with the small discs it touches
+    cv::Mat large = createSyntheticImage(3000, 2000, 100);
+    cv::circle(large, cv::Point(1500, 1000), 600, cv::Scalar(120, 60, 170), cv::FILLED);
+    if (!sameObjects("large", large, 256, 1)) {
+        failures++;
+    }
+
+    return failures == 0 ? 0 : 1;
+}